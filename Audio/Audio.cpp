@@ -18,27 +18,36 @@
 #include "Audio.h"
 
 #include "../Configuration.h"
+#include "../Console.h"
+#include "SoundCache.h"
 
 #define WIN32_LEAN_AND_MEAN
 #include "nlnx/audio.hpp"
 #include "nlnx/nx.hpp"
 
-#include <cstddef>
-
 namespace jrc
 {
 constexpr const char* Error::messages[];
 
-Sound::Sound() noexcept : id{0}
+namespace
+{
+// Milliseconds to fade out the old and fade in the new background music.
+constexpr int FADE_TIME = 500;
+} // namespace
+
+Sound::Sound() noexcept : audio{}
 {
 }
 
-Sound::Sound(Name name) noexcept : id{sound_ids[name]}
+Sound::Sound(Name name) noexcept : audio{sounds[name]}
 {
 }
 
-Sound::Sound(nl::node src) noexcept : id{add_sound(src)}
+Sound::Sound(nl::node src) noexcept : audio{src}
 {
+    if (initialized) {
+        SoundCache::get().prefetch(audio);
+    }
 }
 
 void Sound::play() const noexcept
@@ -47,9 +56,16 @@ void Sound::play() const noexcept
         return;
     }
 
-    if (auto sample_iter = samples.find(id); sample_iter != samples.end()) {
-        Mix_PlayChannel(-1, sample_iter->second, 0);
+    SoundCache::get().play(audio);
+}
+
+void Sound::prefetch(nl::node src) noexcept
+{
+    if (!initialized) {
+        return;
     }
+
+    SoundCache::get().prefetch(src);
 }
 
 Error Sound::init()
@@ -71,6 +87,8 @@ Error Sound::init()
     // Allocate 16 channels for playing sound effects.
     Mix_AllocateChannels(16);
 
+    SoundCache::get().start();
+
     nl::node ui_src = nl::nx::sound["UI.img"];
 
     add_sound(Sound::BUTTON_CLICK, ui_src["BtMouseClick"]);
@@ -86,14 +104,13 @@ Error Sound::init()
     add_sound(Sound::PORTAL, game_src["Portal"]);
     add_sound(Sound::LEVEL_UP, game_src["LevelUp"]);
 
-    set_sfx_volume(Configuration::get().audio.volume.sound_effects);
-
     return Error::NONE;
 }
 
 void Sound::init_sfx() noexcept
 {
     initialized = true;
+    set_sfx_volume(Configuration::get().audio.volume.sound_effects);
 }
 
 Mix_Music* Music::stream;
@@ -109,10 +126,7 @@ void Sound::close() noexcept
         Mix_FreeMusic(Music::stream);
     }
 
-    for (auto [_, sample] : samples) {
-        Mix_FreeChunk(sample);
-    }
-    samples.clear();
+    SoundCache::get().stop();
 
     Mix_CloseAudio();
     Mix_Quit();
@@ -130,39 +144,11 @@ void Sound::set_sfx_volume(std::uint8_t vol) noexcept
     Mix_Volume(-1, MIX_MAX_VOLUME * static_cast<int>(vol) / 100);
 }
 
-std::size_t Sound::add_sound(nl::node src) noexcept
-{
-    if (!initialized) {
-        return 0;
-    }
-
-    nl::audio ad = src;
-
-    auto data = static_cast<const std::byte*>(ad.data());
-
-    if (data) {
-        std::size_t id = ad.id();
-
-        samples[id] = Mix_LoadWAV_RW(
-            SDL_RWFromConstMem(data + 82, ad.length() - 82), 0);
-
-        return id;
-    } else {
-        return 0;
-    }
-}
-
 void Sound::add_sound(Name name, nl::node src) noexcept
 {
-    if (!initialized) {
-        return;
-    }
-
-    std::size_t id = add_sound(src);
-
-    if (id) {
-        sound_ids[name] = id;
-    }
+    // The preloaded sounds are always kept decoded.
+    sounds[name] = src;
+    SoundCache::get().pin(sounds[name]);
 }
 
 bool Sound::is_initialized() noexcept
@@ -170,8 +156,7 @@ bool Sound::is_initialized() noexcept
     return initialized;
 }
 
-std::unordered_map<std::size_t, Mix_Chunk*> Sound::samples;
-EnumMap<Sound::Name, std::size_t> Sound::sound_ids;
+EnumMap<Sound::Name, nl::audio> Sound::sounds;
 bool Sound::initialized = false;
 
 Error Music::play(const std::string& bgm_path)
@@ -187,26 +172,44 @@ Error Music::play(const std::string& bgm_path)
     }
 
     nl::audio ad = nl::nx::sound.resolve(bgm_path);
-    auto data = static_cast<const std::byte*>(ad.data());
 
-    if (data) {
+    if (ad.data()) {
+        SoundCache::get().prefetch_music(ad);
         if (stream) {
-            Mix_HaltMusic();
-            Mix_FreeMusic(stream);
-        }
-
-        stream = Mix_LoadMUSType_RW(
-            SDL_RWFromConstMem(data + 82, ad.length() - 82), MUS_OGG, 0);
-        if (Mix_PlayMusic(stream, -1) == -1) {
-            return Error::AUDIO;
+            Mix_FadeOutMusic(FADE_TIME);
         }
 
+        pending = true;
         path = bgm_path;
     }
 
     return Error::NONE;
 }
 
+void Music::update() noexcept
+{
+    if (!pending || Mix_FadingMusic() == MIX_FADING_OUT) {
+        return;
+    }
+
+    Mix_Music* next = SoundCache::get().take_music();
+    if (!next) {
+        return;
+    }
+
+    if (stream) {
+        Mix_HaltMusic();
+        Mix_FreeMusic(stream);
+    }
+
+    stream = next;
+    pending = false;
+
+    if (Mix_FadeInMusic(stream, -1, FADE_TIME) == -1) {
+        Console::get().print(__func__, Mix_GetError());
+    }
+}
+
 void Music::init() noexcept
 {
     stream = nullptr;
@@ -228,5 +231,6 @@ bool Music::is_initialized() noexcept
     return initialized;
 }
 
+bool Music::pending = false;
 bool Music::initialized = false;
 } // namespace jrc
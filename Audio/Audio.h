@@ -18,13 +18,13 @@
 #pragma once
 #include "../Error.h"
 #include "../Template/EnumMap.h"
+#include "nlnx/audio.hpp"
 #include "nlnx/node.hpp"
 
 #include <SDL.h>
 #include <SDL_mixer.h>
 #include <cstdint>
 #include <string>
-#include <unordered_map>
 
 namespace jrc
 {
@@ -57,6 +57,10 @@ public:
 
     void play() const noexcept;
 
+    //! Decode a sound in the background, so that it is ready by the time it
+    //! is first played.
+    static void prefetch(nl::node src) noexcept;
+
     [[nodiscard]] static Error init();
     static void init_sfx() noexcept;
     static void close() noexcept;
@@ -65,20 +69,23 @@ public:
     [[nodiscard]] static bool is_initialized() noexcept;
 
 private:
-    std::size_t id;
+    nl::audio audio;
 
-    static std::size_t add_sound(nl::node src) noexcept;
     static void add_sound(Sound::Name name, nl::node src) noexcept;
 
-    static std::unordered_map<std::size_t, Mix_Chunk*> samples;
-    static EnumMap<Name, std::size_t> sound_ids;
+    static EnumMap<Name, nl::audio> sounds;
     static bool initialized;
 };
 
 class Music
 {
 public:
+    //! Fade over to the background music at the path. The music is decoded
+    //! in the background and started by `update()`.
     [[nodiscard]] static Error play(const std::string& bgm_path);
+    //! Start the requested music once it is decoded and the previous one has
+    //! faded out.
+    static void update() noexcept;
 
     static void init() noexcept;
     static void set_bgm_volume(std::uint8_t volume) noexcept;
@@ -87,6 +94,7 @@ public:
 
 private:
     static Mix_Music* stream;
+    static bool pending;
     static bool initialized;
 
     friend Sound;
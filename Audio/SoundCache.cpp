@@ -0,0 +1,296 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "SoundCache.h"
+
+#include <cstddef>
+
+namespace jrc
+{
+namespace
+{
+// Decoded sound effects are allowed to take up 32 MiB.
+constexpr std::size_t MAX_BYTES = 32 * 1024 * 1024;
+// Sounds are stored after a header of this length.
+constexpr std::size_t HEADER_LENGTH = 82;
+} // namespace
+
+SoundCache::SoundCache() noexcept
+    : running{false}, bytes{0}, music_id{0}, music{nullptr}
+{
+}
+
+void SoundCache::start()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (running) {
+        return;
+    }
+
+    running = true;
+    decoder = std::thread{&SoundCache::run, this};
+}
+
+void SoundCache::stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        running = false;
+    }
+
+    wake.notify_all();
+    if (decoder.joinable()) {
+        decoder.join();
+    }
+
+    for (auto& [_, entry] : chunks) {
+        Mix_FreeChunk(entry.chunk);
+    }
+    chunks.clear();
+    lru.clear();
+    jobs.clear();
+    queued.clear();
+    pinned.clear();
+    bytes = 0;
+
+    if (music) {
+        Mix_FreeMusic(music);
+        music = nullptr;
+    }
+}
+
+void SoundCache::prefetch(nl::audio audio)
+{
+    std::size_t id = audio.id();
+    if (!id || !audio.data()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (chunks.count(id) || !queued.insert(id).second) {
+            return;
+        }
+
+        jobs.push_back({audio, false});
+    }
+
+    wake.notify_one();
+}
+
+void SoundCache::pin(nl::audio audio)
+{
+    std::size_t id = audio.id();
+    if (!id) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        pinned.insert(id);
+
+        if (auto iter = chunks.find(id); iter != chunks.end()) {
+            Entry& entry = iter->second;
+            if (!entry.pinned) {
+                lru.erase(entry.lru);
+                bytes -= entry.chunk->alen;
+                entry.pinned = true;
+            }
+        }
+    }
+
+    prefetch(audio);
+}
+
+void SoundCache::play(nl::audio audio)
+{
+    std::size_t id = audio.id();
+    if (!id) {
+        return;
+    }
+
+    // The chunk is played while holding the lock, so that the decoder thread
+    // cannot free it in between.
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (auto iter = chunks.find(id); iter != chunks.end()) {
+            Entry& entry = iter->second;
+            if (!entry.pinned) {
+                lru.splice(lru.begin(), lru, entry.lru);
+            }
+
+            Mix_PlayChannel(-1, entry.chunk, 0);
+            return;
+        }
+    }
+
+    // Not decoded yet; this is what the decoder thread is there to avoid.
+    Mix_Chunk* chunk = decode_chunk(audio);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    if (Mix_Chunk* inserted = insert(id, chunk)) {
+        Mix_PlayChannel(-1, inserted, 0);
+    }
+}
+
+void SoundCache::prefetch_music(nl::audio audio)
+{
+    if (!audio.data()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        music_id = audio.id();
+        if (music) {
+            Mix_FreeMusic(music);
+            music = nullptr;
+        }
+
+        jobs.push_front({audio, true});
+    }
+
+    wake.notify_one();
+}
+
+Mix_Music* SoundCache::take_music() noexcept
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    Mix_Music* taken = music;
+    music = nullptr;
+
+    return taken;
+}
+
+void SoundCache::run()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true) {
+        wake.wait(lock, [&] { return !running || !jobs.empty(); });
+        if (!running) {
+            return;
+        }
+
+        Job job = jobs.front();
+        jobs.pop_front();
+        std::size_t id = job.audio.id();
+
+        lock.unlock();
+
+        if (job.music) {
+            Mix_Music* decoded = decode_music(job.audio);
+
+            lock.lock();
+            if (id == music_id && !music) {
+                music = decoded;
+            } else if (decoded) {
+                // Another music was requested in the meantime.
+                Mix_FreeMusic(decoded);
+            }
+        } else {
+            Mix_Chunk* decoded = decode_chunk(job.audio);
+
+            lock.lock();
+            queued.erase(id);
+            insert(id, decoded);
+        }
+    }
+}
+
+Mix_Chunk* SoundCache::insert(std::size_t id, Mix_Chunk* chunk)
+{
+    if (!chunk) {
+        return nullptr;
+    }
+
+    if (auto iter = chunks.find(id); iter != chunks.end()) {
+        // Decoded twice, keep the first one.
+        Mix_FreeChunk(chunk);
+        return iter->second.chunk;
+    }
+
+    Entry entry{chunk, pinned.count(id) > 0, lru.end()};
+    if (!entry.pinned) {
+        lru.push_front(id);
+        entry.lru = lru.begin();
+    }
+
+    chunks.emplace(id, entry);
+    if (entry.pinned) {
+        return chunk;
+    }
+
+    bytes += chunk->alen;
+
+    // The new chunk is at the front, and is never freed right away.
+    auto victim = lru.end();
+    while (bytes > MAX_BYTES && --victim != lru.begin()) {
+        auto iter = chunks.find(*victim);
+        if (is_playing(iter->second.chunk)) {
+            // Freeing the chunk would cut it off.
+            continue;
+        }
+
+        bytes -= iter->second.chunk->alen;
+        Mix_FreeChunk(iter->second.chunk);
+        chunks.erase(iter);
+        victim = lru.erase(victim);
+    }
+
+    return chunk;
+}
+
+bool SoundCache::is_playing(const Mix_Chunk* chunk) noexcept
+{
+    int channels = Mix_AllocateChannels(-1);
+    for (int channel = 0; channel < channels; ++channel) {
+        if (Mix_Playing(channel) && Mix_GetChunk(channel) == chunk) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Mix_Chunk* SoundCache::decode_chunk(nl::audio audio) noexcept
+{
+    auto data = static_cast<const std::byte*>(audio.data());
+    if (!data || audio.length() <= HEADER_LENGTH) {
+        return nullptr;
+    }
+
+    SDL_RWops* src = SDL_RWFromConstMem(data + HEADER_LENGTH,
+                                        audio.length() - HEADER_LENGTH);
+
+    return Mix_LoadWAV_RW(src, 1);
+}
+
+Mix_Music* SoundCache::decode_music(nl::audio audio) noexcept
+{
+    auto data = static_cast<const std::byte*>(audio.data());
+    if (!data || audio.length() <= HEADER_LENGTH) {
+        return nullptr;
+    }
+
+    SDL_RWops* src = SDL_RWFromConstMem(data + HEADER_LENGTH,
+                                        audio.length() - HEADER_LENGTH);
+
+    return Mix_LoadMUSType_RW(src, MUS_OGG, 1);
+}
+} // namespace jrc
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Singleton.h"
+#include "nlnx/audio.hpp"
+
+#include <SDL_mixer.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace jrc
+{
+//! Decodes sounds on a background thread and keeps a bounded number of
+//! decoded chunks around, keyed by `nl::audio::id()`.
+//!
+//! The least recently played chunks are freed once the decoded size of the
+//! unpinned chunks goes over budget. Chunks which are still playing are
+//! skipped, and pinned ones stay loaded until `stop()`.
+class SoundCache : public Singleton<SoundCache>
+{
+public:
+    SoundCache() noexcept;
+
+    //! Start the decoder thread. Requires the audio device to be open.
+    void start();
+    //! Stop the decoder thread and free everything that was decoded.
+    void stop() noexcept;
+
+    //! Queue a sound for decoding, unless it is already decoded or queued.
+    void prefetch(nl::audio audio);
+    //! Queue a sound for decoding, and keep it loaded once decoded.
+    void pin(nl::audio audio);
+    //! Play a sound on a free channel. Sounds which are not decoded yet are
+    //! decoded on the calling thread.
+    void play(nl::audio audio);
+
+    //! Queue a background music for decoding. Replaces any music which was
+    //! decoded but not taken yet.
+    void prefetch_music(nl::audio audio);
+    //! Take the music requested last, or `nullptr` if it is not decoded yet.
+    //! The caller owns the returned music.
+    Mix_Music* take_music() noexcept;
+
+private:
+    struct Job {
+        nl::audio audio;
+        bool music;
+    };
+
+    struct Entry {
+        Mix_Chunk* chunk;
+        bool pinned;
+        std::list<std::size_t>::iterator lru;
+    };
+
+    void run();
+    //! Add a decoded chunk, and free chunks which are over budget. Requires
+    //! `mutex`.
+    Mix_Chunk* insert(std::size_t id, Mix_Chunk* chunk);
+
+    static bool is_playing(const Mix_Chunk* chunk) noexcept;
+    static Mix_Chunk* decode_chunk(nl::audio audio) noexcept;
+    static Mix_Music* decode_music(nl::audio audio) noexcept;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread decoder;
+    bool running;
+
+    std::deque<Job> jobs;
+    std::unordered_set<std::size_t> queued;
+    std::unordered_set<std::size_t> pinned;
+    std::unordered_map<std::size_t, Entry> chunks;
+    //! Ids of the unpinned chunks, most recently used first.
+    std::list<std::size_t> lru;
+    //! Decoded size of the unpinned chunks.
+    std::size_t bytes;
+
+    std::size_t music_id;
+    Mix_Music* music;
+};
+} // namespace jrc
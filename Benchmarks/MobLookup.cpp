@@ -0,0 +1,398 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+
+// Times the lookups `MapMobs` makes for attacks and touch damage, through
+// the sorted sweep it keeps its hitboxes in and through the scan over all
+// mobs it used before.
+//
+// Real mobs need the NX files, so the mobs here are synthetic: 300 hitboxes
+// spread over a large map, which move a few pixels before every update.
+// The lookups repeat the logic of `MapMobs::find_closest()` and
+// `MapMobs::find_colliding()` on top of either structure.
+
+#include "Template/SweepList.h"
+#include "boost/container/flat_map.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace jrc
+{
+namespace
+{
+constexpr std::int32_t NUM_MOBS = 300;
+constexpr std::int32_t NUM_UPDATES = 1000;
+constexpr std::int32_t LOOKUPS_PER_UPDATE = 16;
+constexpr std::int16_t MAP_WIDTH = 6000;
+//! Mobs stand on platforms at these heights.
+constexpr std::int16_t PLATFORMS[] = {-800, -500, -200, 100, 400, 700};
+
+struct Mob {
+    std::int32_t oid;
+    Point<std::int16_t> position;
+    //! The hitbox around the position.
+    Rectangle<std::int16_t> shape;
+    bool alive;
+
+    Rectangle<std::int16_t> get_hitbox() const
+    {
+        Rectangle<std::int16_t> bounds = shape;
+        bounds.shift(position);
+        return bounds;
+    }
+};
+
+using Targets = boost::container::flat_map<std::uint16_t, std::int32_t>;
+
+//! Same as `MapMobs::find_closest()`, with `visit_in_range(range, visit)`
+//! calling `visit` with the live mobs in the range.
+template<typename Visit>
+Targets find_closest(Visit&& visit_in_range,
+                     Rectangle<std::int16_t> range,
+                     Point<std::int16_t> origin,
+                     std::uint8_t mob_count)
+{
+    if (mob_count == 0) {
+        return {};
+    }
+    if (mob_count == 1) {
+        auto closest_oid = std::numeric_limits<std::int32_t>::lowest();
+        auto closest_distance = std::numeric_limits<std::uint16_t>::max();
+        visit_in_range(range, [&](const Mob& mob) {
+            auto distance
+                = static_cast<std::uint16_t>(mob.position.disp(origin));
+
+            if (distance < closest_distance) {
+                closest_distance = distance;
+                closest_oid = mob.oid;
+            }
+
+            return true;
+        });
+
+        if (closest_oid == std::numeric_limits<std::int32_t>::lowest()) {
+            return {};
+        } else {
+            return {{{closest_distance, closest_oid}}};
+        }
+    }
+
+    Targets targets;
+    targets.reserve(mob_count + 1);
+
+    visit_in_range(range, [&](const Mob& mob) {
+        auto distance = static_cast<std::uint16_t>(mob.position.disp(origin));
+        targets.emplace(distance, mob.oid);
+
+        if (targets.size() > mob_count) {
+            auto furthest = targets.end();
+            --furthest;
+            targets.erase(furthest);
+        }
+
+        return true;
+    });
+
+    return targets;
+}
+
+//! Same as `MapMobs::find_colliding()`, for a player which moved from
+//! `last` to `now`.
+template<typename Visit>
+std::int32_t find_colliding(Visit&& visit_in_range,
+                            Point<std::int16_t> last,
+                            Point<std::int16_t> now)
+{
+    Range<std::int16_t> horizontal{last.x(), now.x()};
+    Range<std::int16_t> vertical{last.y(), now.y()};
+    Rectangle<std::int16_t> player_rect{horizontal.smaller(),
+                                        horizontal.greater(),
+                                        vertical.smaller()
+                                            - static_cast<std::int16_t>(50),
+                                        vertical.greater()};
+
+    std::int32_t colliding = 0;
+    visit_in_range(player_rect, [&colliding](const Mob& mob) {
+        colliding = mob.oid;
+        return false;
+    });
+
+    return colliding;
+}
+
+//! The mobs as `MapObjects` stores them, which the old lookups went
+//! through one by one.
+class LinearScan
+{
+public:
+    explicit LinearScan(
+        const std::unordered_map<std::int32_t, std::unique_ptr<Mob>>& mobs)
+        : mobs{mobs}
+    {
+    }
+
+    template<typename Visitor>
+    void operator()(const Rectangle<std::int16_t>& range,
+                    Visitor&& visit) const
+    {
+        for (const auto& mmo : mobs) {
+            const Mob& mob = *mmo.second;
+            if (mob.alive && range.overlaps(mob.get_hitbox())
+                && !visit(mob)) {
+                return;
+            }
+        }
+    }
+
+private:
+    const std::unordered_map<std::int32_t, std::unique_ptr<Mob>>& mobs;
+};
+
+//! The hitboxes as `MapMobs` keeps them now.
+class Sweep
+{
+public:
+    explicit Sweep(const SweepList<const Mob*>& hitboxes)
+        : hitboxes{hitboxes}
+    {
+    }
+
+    template<typename Visitor>
+    void operator()(const Rectangle<std::int16_t>& range,
+                    Visitor&& visit) const
+    {
+        hitboxes.visit(range, [&visit](const Mob* mob) {
+            return !mob->alive || visit(*mob);
+        });
+    }
+
+private:
+    const SweepList<const Mob*>& hitboxes;
+};
+
+struct Timer {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration total{};
+    Clock::time_point start;
+
+    void begin()
+    {
+        start = Clock::now();
+    }
+
+    void end()
+    {
+        total += Clock::now() - start;
+    }
+
+    //! The average time in nanoseconds over `count` runs.
+    double average(std::int64_t count) const
+    {
+        return std::chrono::duration<double, std::nano>(total).count()
+               / static_cast<double>(count);
+    }
+};
+
+//! One attack or touch damage check, with the same inputs for both
+//! structures.
+struct Lookup {
+    Rectangle<std::int16_t> range;
+    Point<std::int16_t> origin;
+    std::uint8_t mob_count;
+    Point<std::int16_t> last;
+    Point<std::int16_t> now;
+};
+
+//! Whether both found the same distances. Mobs at the same distance can
+//! be found in any order.
+bool same_targets(const Targets& first, const Targets& second)
+{
+    if (first.size() != second.size()) {
+        return false;
+    }
+
+    for (auto a = first.begin(), b = second.begin(); a != first.end();
+         ++a, ++b) {
+        if (a->first != b->first) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int run()
+{
+    std::mt19937 rng{20190101};
+    std::uniform_int_distribution<int> random_x{0, MAP_WIDTH};
+    std::uniform_int_distribution<std::size_t> random_platform{
+        0, std::size(PLATFORMS) - 1};
+    std::uniform_int_distribution<int> random_width{40, 160};
+    std::uniform_int_distribution<int> random_height{40, 120};
+    std::uniform_int_distribution<int> random_step{-3, 3};
+    std::uniform_int_distribution<int> random_percent{0, 99};
+    std::uniform_int_distribution<int> random_count{1, 15};
+
+    std::unordered_map<std::int32_t, std::unique_ptr<Mob>> mobs;
+    SweepList<const Mob*> hitboxes;
+    for (std::int32_t oid = 1; oid <= NUM_MOBS; ++oid) {
+        auto w = static_cast<std::int16_t>(random_width(rng));
+        auto h = static_cast<std::int16_t>(random_height(rng));
+        auto mob = std::make_unique<Mob>(
+            Mob{oid,
+                {static_cast<std::int16_t>(random_x(rng)),
+                 PLATFORMS[random_platform(rng)]},
+                {static_cast<std::int16_t>(-w / 2),
+                 static_cast<std::int16_t>(w / 2),
+                 static_cast<std::int16_t>(-h),
+                 0},
+                random_percent(rng) >= 10});
+        hitboxes.add(mob.get());
+        mobs.emplace(oid, std::move(mob));
+    }
+
+    LinearScan linear_scan{mobs};
+    Sweep sweep{hitboxes};
+
+    Timer refresh_time;
+    Timer closest_linear;
+    Timer closest_sweep;
+    Timer colliding_linear;
+    Timer colliding_sweep;
+    std::int64_t mismatches = 0;
+    std::int64_t targets_found = 0;
+    std::int64_t collisions_found = 0;
+    std::vector<Lookup> lookups(LOOKUPS_PER_UPDATE);
+
+    for (std::int32_t update = 0; update < NUM_UPDATES; ++update) {
+        for (auto& mmo : mobs) {
+            Point<std::int16_t>& position = mmo.second->position;
+            position.shift_x(static_cast<std::int16_t>(random_step(rng)));
+        }
+
+        refresh_time.begin();
+        hitboxes.refresh(
+            [](const Mob* mob, Rectangle<std::int16_t>& bounds) {
+                bounds = mob->get_hitbox();
+                return true;
+            });
+        refresh_time.end();
+
+        // Attacks reach up to 400 pixels to one side of the player, who
+        // stands on one of the platforms like the mobs.
+        for (Lookup& lookup : lookups) {
+            auto x = static_cast<std::int16_t>(random_x(rng));
+            std::int16_t y = PLATFORMS[random_platform(rng)];
+            auto reach = static_cast<std::int16_t>(random_width(rng) * 5 / 2);
+            bool to_left = random_percent(rng) < 50;
+            lookup.origin = {x, y};
+            lookup.range = {static_cast<std::int16_t>(to_left ? x - reach : x),
+                            static_cast<std::int16_t>(to_left ? x : x + reach),
+                            static_cast<std::int16_t>(y - 100),
+                            static_cast<std::int16_t>(y + 20)};
+            lookup.mob_count = static_cast<std::uint8_t>(random_count(rng));
+            lookup.last = {static_cast<std::int16_t>(x - random_step(rng)),
+                           y};
+            lookup.now = {x, y};
+        }
+
+        std::vector<Targets> expected;
+        closest_linear.begin();
+        for (const Lookup& lookup : lookups) {
+            expected.push_back(find_closest(
+                linear_scan, lookup.range, lookup.origin, lookup.mob_count));
+        }
+        closest_linear.end();
+
+        std::vector<Targets> found;
+        closest_sweep.begin();
+        for (const Lookup& lookup : lookups) {
+            found.push_back(find_closest(
+                sweep, lookup.range, lookup.origin, lookup.mob_count));
+        }
+        closest_sweep.end();
+
+        for (std::size_t i = 0; i < lookups.size(); ++i) {
+            targets_found += static_cast<std::int64_t>(found[i].size());
+            if (!same_targets(expected[i], found[i])) {
+                ++mismatches;
+            }
+        }
+
+        std::vector<std::int32_t> expected_oids;
+        colliding_linear.begin();
+        for (const Lookup& lookup : lookups) {
+            expected_oids.push_back(
+                find_colliding(linear_scan, lookup.last, lookup.now));
+        }
+        colliding_linear.end();
+
+        std::vector<std::int32_t> found_oids;
+        colliding_sweep.begin();
+        for (const Lookup& lookup : lookups) {
+            found_oids.push_back(
+                find_colliding(sweep, lookup.last, lookup.now));
+        }
+        colliding_sweep.end();
+
+        // Either finds any of the mobs touching the player.
+        for (std::size_t i = 0; i < lookups.size(); ++i) {
+            if (found_oids[i] != 0) {
+                ++collisions_found;
+            }
+            if ((expected_oids[i] == 0) != (found_oids[i] == 0)) {
+                ++mismatches;
+            }
+        }
+    }
+
+    const std::int64_t count
+        = static_cast<std::int64_t>(NUM_UPDATES) * LOOKUPS_PER_UPDATE;
+    std::cout << NUM_MOBS << " mobs, " << NUM_UPDATES << " updates, "
+              << count << " lookups of each kind\n"
+              << std::fixed << std::setprecision(0)
+              << "                    linear scan   sorted sweep\n"
+              << "    find_closest    " << std::setw(8)
+              << closest_linear.average(count) << " ns   " << std::setw(9)
+              << closest_sweep.average(count) << " ns\n"
+              << "    find_colliding  " << std::setw(8)
+              << colliding_linear.average(count) << " ns   " << std::setw(9)
+              << colliding_sweep.average(count) << " ns\n"
+              << "    refresh                        " << std::setw(9)
+              << refresh_time.average(NUM_UPDATES) << " ns per update\n"
+              << "    targets found   " << targets_found << '\n'
+              << "    collisions      " << collisions_found << '\n'
+              << "    mismatches      " << mismatches << '\n';
+
+    return mismatches == 0 ? 0 : 1;
+}
+} // namespace
+} // namespace jrc
+
+int main()
+{
+    return jrc::run();
+}
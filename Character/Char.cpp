@@ -82,10 +82,7 @@ void Char::draw(double viewx, double viewy, float alpha) const
 
 bool Char::update(const Physics& physics, float speed)
 {
-    damage_numbers.erase(std::remove_if(damage_numbers.begin(),
-                                        damage_numbers.end(),
-                                        [](auto& dn) { return dn.update(); }),
-                         damage_numbers.end());
+    damage_numbers.remove_if([](auto& dn) { return dn.update(); });
     effects.update();
     chat_balloon.update();
     invincible.update();
@@ -372,8 +369,6 @@ PhysicsObject& Char::get_phobj()
 
 void Char::init()
 {
-    CharLook::init();
-
     nl::node src = nl::nx::effect["BasicEff.img"];
     for (auto path : CharEffect::PATHS) {
         char_effects.emplace(path.first, src.resolve(path.second));
@@ -22,6 +22,7 @@
 #include "../Graphics/EffectLayer.h"
 #include "../IO/Components/ChatBalloon.h"
 #include "../Template/EnumMap.h"
+#include "../Template/FixedPool.h"
 #include "../Template/Rectangle.h"
 #include "../Util/TimedBool.h"
 #include "CharEffect.h"
@@ -145,6 +146,8 @@ public:
     PhysicsObject& get_phobj();
 
     //! Initialize character effects.
+    //!
+    //! The body draw info is loaded separately by `CharLook::init()`.
     static void init();
 
 protected:
@@ -163,13 +166,16 @@ protected:
     bool flip;
 
 private:
+    //! The most damage numbers shown above a character at once.
+    static constexpr std::size_t MAX_DAMAGE_NUMBERS = 16;
+
     Text name_label;
     ChatBalloon chat_balloon;
     EffectLayer effects;
     Afterimage afterimage;
     TimedBool invincible;
     TimedBool iron_body;
-    std::vector<DamageNumber> damage_numbers;
+    FixedPool<DamageNumber, MAX_DAMAGE_NUMBERS> damage_numbers;
 
     static EnumMap<CharEffect::Id, Animation> char_effects;
 };
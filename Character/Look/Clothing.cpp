@@ -19,8 +19,8 @@
 
 #include "../../Data/EquipData.h"
 #include "../../Data/WeaponData.h"
+#include "../../Util/NxPath.h"
 #include "nlnx/node.hpp"
-#include "nlnx/nx.hpp"
 
 #include <string>
 #include <unordered_set>
@@ -70,11 +70,8 @@ Clothing::Clothing(std::int32_t id, const BodyDrawinfo& drawinfo) : item_id(id)
         chlayer = Layer::CAPE;
     }
 
-    std::string str_id = std::to_string(item_id);
-    str_id.insert(0, "0", 1);
-    str_id += ".img";
-    nl::node src
-        = nl::nx::character[equipdata.get_item_data().get_category()][str_id];
+    nl::node src = NodeCache::get().equip(
+        equipdata.get_item_data().get_category(), item_id);
     nl::node info = src["info"];
 
     vslot = info["vslot"].get_string();
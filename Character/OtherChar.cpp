@@ -28,41 +28,28 @@ OtherChar::OtherChar(std::int32_t id,
                      std::string&& nm,
                      std::int8_t st,
                      Point<std::int16_t> pos) noexcept
-    : Char{id, lk, std::move(nm)}
+    : Char{id, lk, std::move(nm)},
+      movements{pos, static_cast<std::uint8_t>(st)}
 {
     level = lvl;
     job = jb;
     set_position(pos);
 
-    lastmove.xpos = pos.x();
-    lastmove.ypos = pos.y();
-    lastmove.newstate = st;
-    timer = 0;
-
     attackspeed = 6;
     attacking = false;
 }
 
 std::int8_t OtherChar::update(const Physics& physics)
 {
-    if (timer > 1) {
-        --timer;
-    } else if (timer == 1) {
-        if (!movements.empty()) {
-            lastmove = movements.front();
-            movements.pop();
-        } else {
-            timer = 0;
-        }
-    }
+    movements.update();
 
     if (!attacking) {
-        std::uint8_t laststate = lastmove.newstate;
-        set_state(laststate);
+        set_state(movements.get_stance());
     }
 
-    ph_obj.hspeed = lastmove.xpos - ph_obj.crnt_x();
-    ph_obj.vspeed = lastmove.ypos - ph_obj.crnt_y();
+    Point<std::int16_t> position = movements.get_position();
+    ph_obj.hspeed = position.x() - ph_obj.crnt_x();
+    ph_obj.vspeed = position.y() - ph_obj.crnt_y();
     ph_obj.move();
 
     physics.get_fht().update_fh(ph_obj);
@@ -75,14 +62,24 @@ std::int8_t OtherChar::update(const Physics& physics)
     return get_layer();
 }
 
-void OtherChar::send_movement(const std::vector<Movement>& newmoves)
+std::int8_t OtherChar::update_far(const Physics& physics,
+                                  std::uint16_t steps)
 {
-    movements.push(newmoves.back());
+    movements.update(steps);
 
-    if (timer == 0) {
-        constexpr std::uint16_t DELAY = 50;
-        timer = DELAY;
-    }
+    // Any attack will be over by the time the character is seen again.
+    attacking = false;
+    set_state(movements.get_stance());
+    set_position(movements.get_position());
+
+    physics.get_fht().update_fh(ph_obj);
+
+    return get_layer();
+}
+
+void OtherChar::send_movement(const std::vector<Movement>& newmoves)
+{
+    movements.push(newmoves);
 }
 
 void OtherChar::update_skill(std::int32_t skillid, std::uint8_t skilllevel)
@@ -99,8 +96,7 @@ void OtherChar::update_look(const LookEntry& newlook)
 {
     look = newlook;
 
-    std::uint8_t laststate = lastmove.newstate;
-    set_state(laststate);
+    set_state(movements.get_stance());
 }
 
 std::int8_t OtherChar::get_integer_attack_speed() const
@@ -16,11 +16,10 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
-#include "../Gameplay/Movement.h"
+#include "../Gameplay/MovementBuffer.h"
 #include "Char.h"
 #include "Look/CharLook.h"
 
-#include <queue>
 #include <vector>
 
 namespace jrc
@@ -39,6 +38,9 @@ public:
 
     //! Update the character.
     std::int8_t update(const Physics& physics) override;
+    //! Move the character along its movements without animating it.
+    std::int8_t update_far(const Physics& physics,
+                           std::uint16_t steps) override;
     //! Add the movements which this character will go through next.
     void send_movement(const std::vector<Movement>& movements);
 
@@ -59,9 +61,7 @@ public:
 private:
     std::uint16_t level;
     std::int16_t job;
-    std::queue<Movement> movements;
-    Movement lastmove;
-    std::uint16_t timer;
+    MovementBuffer movements;
 
     std::unordered_map<std::int32_t, std::uint8_t> skilllevels;
     std::uint8_t attackspeed;
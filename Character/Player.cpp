@@ -79,6 +79,7 @@ Player::Player() : Char{0, {}, u8""}
 void Player::respawn(Point<std::int16_t> pos, bool uw)
 {
     set_position(pos.x(), pos.y());
+    movements.reset(pos);
     underwater = uw;
     keys_down.clear();
     attacking = false;
@@ -86,6 +87,14 @@ void Player::respawn(Point<std::int16_t> pos, bool uw)
     null_state.update_state(*this);
 }
 
+void Player::flush_movement()
+{
+    std::vector<Movement> moves = movements.flush();
+    if (!moves.empty()) {
+        MovePlayerPacket(moves).dispatch();
+    }
+}
+
 void Player::send_action(KeyAction::Id action, bool down)
 {
     if (const PlayerState* pst = get_state(state); pst) {
@@ -192,11 +201,8 @@ std::int8_t Player::update(const Physics& physics)
     }
 
     std::uint8_t stancebyte = flip ? state : state + 1;
-    Movement newmove(ph_obj, stancebyte);
-    bool needupdate = last_move.hasmoved(newmove);
-    if (needupdate) {
-        MovePlayerPacket(newmove).dispatch();
-        last_move = newmove;
+    if (movements.record(ph_obj, stancebyte)) {
+        flush_movement();
     }
 
     return get_layer();
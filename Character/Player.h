@@ -20,7 +20,7 @@
 #include "../Gameplay/Combat/Skill.h"
 #include "../Gameplay/MapleMap/Layer.h"
 #include "../Gameplay/MapleMap/MapInfo.h"
-#include "../Gameplay/Movement.h"
+#include "../Gameplay/MovementRecorder.h"
 #include "../Gameplay/Physics/Physics.h"
 #include "../Gameplay/Playable.h"
 #include "../Util/Randomizer.h"
@@ -60,6 +60,9 @@ public:
 
     //! Respawn the player at the given position.
     void respawn(Point<std::int16_t> position, bool underwater);
+    //! Send the movement recorded so far to the server, so that it arrives
+    //! before a packet which depends on the player's position.
+    void flush_movement();
     //! Sends a Keyaction to the player's state, to apply forces, change the
     //! state and other behaviour.
     void send_action(KeyAction::Id action, bool pressed) override;
@@ -176,7 +179,7 @@ private:
 
     std::unordered_map<KeyAction::Id, bool> keys_down;
 
-    Movement last_move;
+    MovementRecorder movements;
 
     nullable_ptr<const Ladder> ladder;
     bool underwater;
@@ -54,6 +54,7 @@ void Configuration::load() noexcept(false)
     auto audio_table = settings->get_table("audio");
     auto account_table = settings->get_table("account");
     auto ui_table = settings->get_table("ui");
+    auto performance_table = settings->get_table("performance");
 
     if (network_table) {
         if (auto ip = network_table->get_as<std::string>("ip"); ip) {
@@ -71,6 +72,15 @@ void Configuration::load() noexcept(false)
                 "No valid value for \"settings.toml:network.port\" found; "
                 "using default.");
         }
+
+        if (auto hash_seed = network_table->get_as<std::int64_t>("hash_seed");
+            hash_seed) {
+            network.hash_seed = static_cast<std::uint64_t>(*hash_seed);
+        } else {
+            Console::get().print(
+                "No valid value for \"settings.toml:network.hash_seed\" "
+                "found; using default.");
+        }
     } else {
         Console::get().print(
             "No valid table \"settings.toml:network\" found; using default.");
@@ -102,6 +112,25 @@ void Configuration::load() noexcept(false)
                 "No valid value for \"settings.toml:video.low_quality\" "
                 "found; using default.");
         }
+
+        if (auto backend = video_table->get_as<std::string>("backend");
+            backend) {
+            video.backend = *backend;
+        } else {
+            Console::get().print(
+                "No valid value for \"settings.toml:video.backend\" found; "
+                "using default.");
+        }
+
+        if (auto atlas_format
+            = video_table->get_as<std::string>("atlas_format");
+            atlas_format) {
+            video.atlas_format = *atlas_format;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:video.atlas_format\" "
+                                 "found; using default.");
+        }
     } else {
         Console::get().print(
             "No valid table \"settings.toml:video\" found; using default.");
@@ -123,6 +152,22 @@ void Configuration::load() noexcept(false)
                 "No valid value for \"settings.toml:fonts.bold\" found; "
                 "using default.");
         }
+
+        if (auto locale = fonts_table->get_as<std::string>("locale"); locale) {
+            fonts.locale = *locale;
+        } else {
+            Console::get().print(
+                "No valid value for \"settings.toml:fonts.locale\" found; "
+                "using default.");
+        }
+
+        if (auto sdf = fonts_table->get_as<bool>("sdf"); sdf) {
+            fonts.sdf = *sdf;
+        } else {
+            Console::get().print(
+                "No valid value for \"settings.toml:fonts.sdf\" found; "
+                "using default.");
+        }
     } else {
         Console::get().print(
             "No valid table \"settings.toml:fonts\" found; using default.");
@@ -423,6 +468,110 @@ void Configuration::load() noexcept(false)
             "No valid table \"settings.toml:ui\" found; using default.");
     }
 
+    if (performance_table) {
+        if (auto bitmap_cache
+            = performance_table->get_as<bool>("bitmap_cache");
+            bitmap_cache) {
+            performance.bitmap_cache = *bitmap_cache;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.bitmap_"
+                                 "cache\" found; using default.");
+        }
+        if (auto render_thread
+            = performance_table->get_as<bool>("render_thread");
+            render_thread) {
+            performance.render_thread = *render_thread;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.render_thread\" "
+                                 "found; using default.");
+        }
+
+        if (auto max_fps
+            = performance_table->get_as<std::uint16_t>("max_fps");
+            max_fps) {
+            performance.max_fps = *max_fps;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.max_fps\" "
+                                 "found; using default.");
+        }
+
+        if (auto max_update_steps
+            = performance_table->get_as<std::uint8_t>("max_update_steps");
+            max_update_steps) {
+            performance.max_update_steps = *max_update_steps;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.max_update_steps"
+                                 "\" found; using default.");
+        }
+
+        if (auto debug_overlay
+            = performance_table->get_as<bool>("debug_overlay");
+            debug_overlay) {
+            performance.debug_overlay = *debug_overlay;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.debug_overlay\" "
+                                 "found; using default.");
+        }
+
+        if (auto benchmark_frames
+            = performance_table->get_as<std::uint32_t>("benchmark_frames");
+            benchmark_frames) {
+            performance.benchmark_frames = *benchmark_frames;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.benchmark_frames"
+                                 "\" found; using default.");
+        }
+
+        if (auto upload_budget
+            = performance_table->get_as<std::uint16_t>("upload_budget");
+            upload_budget) {
+            performance.upload_budget = *upload_budget;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.upload_budget\" "
+                                 "found; using default.");
+        }
+
+        if (auto movement_delay
+            = performance_table->get_as<std::uint16_t>("movement_delay");
+            movement_delay) {
+            performance.movement_delay = *movement_delay;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.movement_delay\""
+                                 " found; using default.");
+        }
+
+        if (auto movement_interval
+            = performance_table->get_as<std::uint16_t>("movement_interval");
+            movement_interval) {
+            performance.movement_interval = *movement_interval;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.movement_interva"
+                                 "l\" found; using default.");
+        }
+
+        if (auto update_margin
+            = performance_table->get_as<std::uint16_t>("update_margin");
+            update_margin) {
+            performance.update_margin = *update_margin;
+        } else {
+            Console::get().print("No valid value for "
+                                 "\"settings.toml:performance.update_margin\" "
+                                 "found; using default.");
+        }
+    } else {
+        Console::get().print("No valid table \"settings.toml:performance\" "
+                             "found; using default.");
+    }
+
     if (auto character_tables = settings->get_table_array("character");
         character_tables) {
         for (const auto& character_table : *character_tables) {
@@ -711,15 +860,20 @@ void Configuration::save() const noexcept
 [network]
 ip = $
 port = $
+hash_seed = $
 
 [video]
 fullscreen = $
 vsync = $
 low_quality = $
+backend = $
+atlas_format = $
 
 [fonts]
 normal = $
 bold = $
+locale = $
+sdf = $
 
 [audio]
 sound_effects = $
@@ -748,7 +902,19 @@ simple_minimap = $
     skillbook = $
     change_channel = $
     game_settings = $
-    system_settings = $)"sv.substr(1);
+    system_settings = $
+
+[performance]
+bitmap_cache = $
+render_thread = $
+max_fps = $
+max_update_steps = $
+debug_overlay = $
+benchmark_frames = $
+upload_budget = $
+movement_delay = $
+movement_interval = $
+update_margin = $)"sv.substr(1);
 
     std::ofstream settings{"settings.toml"};
     if (!settings || !settings.is_open()) {
@@ -801,83 +967,128 @@ simple_minimap = $
                 write(network.port);
                 break;
             case 2:
-                write(video.fullscreen);
+                write(static_cast<std::int64_t>(network.hash_seed));
                 break;
             case 3:
-                write(video.vsync);
+                write(video.fullscreen);
                 break;
             case 4:
-                write(video.low_quality);
+                write(video.vsync);
                 break;
             case 5:
-                write(fonts.normal);
+                write(video.low_quality);
                 break;
             case 6:
-                write(fonts.bold);
+                write(video.backend);
                 break;
             case 7:
-                write(audio.sound_effects);
+                write(video.atlas_format);
                 break;
             case 8:
-                write(audio.music);
+                write(fonts.normal);
                 break;
             case 9:
-                write(audio.volume.sound_effects);
+                write(fonts.bold);
                 break;
             case 10:
-                write(audio.volume.music);
+                write(fonts.locale);
                 break;
             case 11:
-                write(account.save_login);
+                write(fonts.sdf);
                 break;
             case 12:
-                write(account.account_name);
+                write(audio.sound_effects);
                 break;
             case 13:
-                write(account.world);
+                write(audio.music);
                 break;
             case 14:
-                write(account.channel);
+                write(audio.volume.sound_effects);
                 break;
             case 15:
-                write(account.character);
+                write(audio.volume.music);
                 break;
             case 16:
-                write(ui.hp_alert);
+                write(account.save_login);
                 break;
             case 17:
-                write(ui.mp_alert);
+                write(account.account_name);
                 break;
             case 18:
-                write(ui.shake_screen);
+                write(account.world);
                 break;
             case 19:
-                write(ui.simple_minimap);
+                write(account.channel);
                 break;
             case 20:
-                write(ui.position.key_config);
+                write(account.character);
                 break;
             case 21:
-                write(ui.position.stats);
+                write(ui.hp_alert);
                 break;
             case 22:
-                write(ui.position.inventory);
+                write(ui.mp_alert);
                 break;
             case 23:
-                write(ui.position.equip_inventory);
+                write(ui.shake_screen);
                 break;
             case 24:
-                write(ui.position.skillbook);
+                write(ui.simple_minimap);
                 break;
             case 25:
-                write(ui.position.change_channel);
+                write(ui.position.key_config);
                 break;
             case 26:
-                write(ui.position.game_settings);
+                write(ui.position.stats);
                 break;
             case 27:
+                write(ui.position.inventory);
+                break;
+            case 28:
+                write(ui.position.equip_inventory);
+                break;
+            case 29:
+                write(ui.position.skillbook);
+                break;
+            case 30:
+                write(ui.position.change_channel);
+                break;
+            case 31:
+                write(ui.position.game_settings);
+                break;
+            case 32:
                 write(ui.position.system_settings);
                 break;
+            case 33:
+                write(performance.bitmap_cache);
+                break;
+            case 34:
+                write(performance.render_thread);
+                break;
+            case 35:
+                write(performance.max_fps);
+                break;
+            case 36:
+                write(performance.max_update_steps);
+                break;
+            case 37:
+                write(performance.debug_overlay);
+                break;
+            case 38:
+                write(performance.benchmark_frames);
+                break;
+            case 39:
+                write(performance.upload_budget);
+                break;
+            case 40:
+                write(performance.movement_delay);
+                break;
+            case 41:
+                write(performance.movement_interval);
+                break;
+            case 42:
+                write(performance.update_margin);
+                break;
             default:
                 Console::get().print(
                     "[logic error] Number of `case` statements in "
@@ -85,17 +85,34 @@ struct Configuration : public Singleton<Configuration> {
     struct Network {
         std::string ip = "127.0.0.1";
         std::uint16_t port = 8484;
+        //! Seed of the server's last NX file check, so that the files can
+        //! be hashed before it is asked for again.
+        std::uint64_t hash_seed = 0;
     };
 
     struct Video {
         bool fullscreen = false;
         bool vsync = true;
         bool low_quality = false;
+        //! Where frames are drawn: "window", or without a display, "null"
+        //! to only record them or "offscreen" to render them in software.
+        std::string backend = "window";
+        //! How the sprite atlas is stored: "rgba8", or "rgba4" or "bc3" to
+        //! use less memory. Low quality mode also uses a smaller atlas, in
+        //! "rgba4" unless "bc3" is set. With "rgba4", sprites with
+        //! gradients are kept in a smaller RGBA8 atlas of their own.
+        std::string atlas_format = "rgba8";
     };
 
     struct Fonts {
         std::string normal = "../fonts/Roboto/Roboto-Regular.ttf";
         std::string bold = "../fonts/Roboto/Roboto-Bold.ttf";
+        //! Language of the game text, which decides the glyphs rendered
+        //! ahead of time, e.g. "en", "de" or "ko".
+        std::string locale = "en";
+        //! Draw text from distance fields shared between all sizes of a
+        //! face, instead of rendering every size separately.
+        bool sdf = false;
     };
 
     struct Audio {
@@ -137,6 +154,34 @@ struct Configuration : public Singleton<Configuration> {
         Position position;
     };
 
+    struct Performance {
+        //! Keep decoded bitmaps in "bitmaps.cache" between sessions.
+        bool bitmap_cache = false;
+        //! Upload, draw and swap frames on a separate thread.
+        bool render_thread = false;
+        //! Frame-rate cap; 0 leaves the frame rate uncapped.
+        std::uint16_t max_fps = 0;
+        //! Most fixed timesteps run in one frame when catching up.
+        std::uint8_t max_update_steps = 5;
+        //! Show frame timing stats; toggled with F12.
+        bool debug_overlay = false;
+        //! If not 0, run exactly one update per frame and quit after this
+        //! many frames, for benchmarks.
+        std::uint32_t benchmark_frames = 0;
+        //! Most KiB of bitmaps uploaded per frame, or 0 for no limit. Bitmaps
+        //! over the budget are drawn from the next frame on.
+        std::uint16_t upload_budget = 2048;
+        //! Least milliseconds by which other characters and mobs trail the
+        //! movements received for them. Raised while packets arrive unevenly.
+        std::uint16_t movement_delay = 100;
+        //! Most milliseconds of the player's movement collected before it is
+        //! sent to the server. Changes of stance or foothold are sent at once.
+        std::uint16_t movement_interval = 100;
+        //! Pixels around the view within which mobs, NPCs and other characters
+        //! are updated every timestep. Farther ones are updated coarsely.
+        std::uint16_t update_margin = 256;
+    };
+
     struct Character {
         struct GameSettings {
             //! whispers = true
@@ -166,6 +211,7 @@ struct Configuration : public Singleton<Configuration> {
     Video video;
     Audio audio;
     Ui ui;
+    Performance performance;
 
     //! Gets a reference to the character-specific configuration for the
     //! character identified by name. **Inserts a new character with the**
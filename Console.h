@@ -21,6 +21,7 @@
 #include "Util/Str.h"
 
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 
@@ -61,6 +62,9 @@ public:
 
     void print(const std::string& str) noexcept
     {
+        // Startup stages print from worker threads.
+        std::lock_guard<std::mutex> lock{mutex};
+
         if (!printed.count(str)) {
             std::cout << str << '\n' << std::flush;
             printed.insert(str);
@@ -68,6 +72,7 @@ public:
     }
 
 private:
+    std::mutex mutex;
     std::unordered_set<std::string> printed;
 };
 
@@ -17,17 +17,15 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "EquipData.h"
 
+#include "../Util/NxPath.h"
 #include "nlnx/node.hpp"
-#include "nlnx/nx.hpp"
 
 namespace jrc
 {
 EquipData::EquipData(std::int32_t id) : itemdata(ItemData::get(id))
 {
-    std::string str_id = std::to_string(id);
-    str_id.insert(0, "0", 1);
-    str_id += ".img";
-    nl::node src = nl::nx::character[itemdata.get_category()][str_id]["info"];
+    nl::node src
+        = NodeCache::get().equip(itemdata.get_category(), id)["info"];
 
     cash = src["cash"].get_bool();
     tradeblock = src["tradeBlock"].get_bool();
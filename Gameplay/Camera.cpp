@@ -19,6 +19,9 @@
 
 #include "../Constants.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace jrc
 {
 Camera::Camera()
@@ -90,4 +93,21 @@ Point<double> Camera::realposition(float alpha) const
 {
     return {x.get(alpha), y.get(alpha)};
 }
+
+Rectangle<std::int16_t> Camera::visible_area(std::uint16_t margin) const
+{
+    auto clamp = [](std::int32_t value) {
+        using limits = std::numeric_limits<std::int16_t>;
+        return static_cast<std::int16_t>(
+            std::clamp<std::int32_t>(value, limits::min(), limits::max()));
+    };
+
+    Point<std::int16_t> pos = position();
+    std::int32_t left = -pos.x() - margin;
+    std::int32_t top = -pos.y() - margin;
+    std::int32_t right = left + Constants::GAME_VIEW_WIDTH + 2 * margin;
+    std::int32_t bottom = top + Constants::GAME_VIEW_HEIGHT + 2 * margin;
+
+    return {clamp(left), clamp(right), clamp(top), clamp(bottom)};
+}
 } // namespace jrc
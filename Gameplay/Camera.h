@@ -19,6 +19,7 @@
 #include "../Template/Interpolated.h"
 #include "../Template/Point.h"
 #include "../Template/Range.h"
+#include "../Template/Rectangle.h"
 
 #include <cstdint>
 
@@ -44,6 +45,8 @@ public:
     Point<std::int16_t> position(float alpha) const;
     // Return the interpolated position.
     Point<double> realposition(float alpha) const;
+    // Return the part of the map which is in view, grown by a margin.
+    Rectangle<std::int16_t> visible_area(std::uint16_t margin) const;
 
 private:
     // Movement variables.
@@ -72,11 +72,7 @@ void Combat::update()
                        }),
         bullets.end());
 
-    damage_numbers.erase(
-        std::remove_if(damage_numbers.begin(),
-                       damage_numbers.end(),
-                       [](DamageNumber& dn) { return dn.update(); }),
-        damage_numbers.end());
+    damage_numbers.remove_if([](DamageNumber& dn) { return dn.update(); });
 }
 
 void Combat::use_move(std::int32_t move_id)
@@ -118,6 +114,7 @@ void Combat::apply_move(const SpecialMove& move)
         apply_use_movement(move);
         apply_result_movement(move, result);
 
+        player.flush_movement();
         AttackPacket(result).dispatch();
     } else {
         move.apply_useeffects(player);
@@ -177,8 +174,7 @@ void Combat::apply_damage_effect(const DamageEffect& effect)
 {
     Point<std::int16_t> head_position
         = mobs.get_mob_head_position(effect.target_oid);
-    damage_numbers.push_back(effect.number);
-    damage_numbers.back().set_x(head_position.x());
+    damage_numbers.emplace_back(effect.number).set_x(head_position.x());
 
     const SpecialMove& move = get_move(effect.move_id);
     mobs.apply_damage(
@@ -17,6 +17,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "../../Character/Player.h"
+#include "../../Template/FixedPool.h"
 #include "../../Template/TimedQueue.h"
 #include "../MapleMap/MapChars.h"
 #include "../MapleMap/MapMobs.h"
@@ -89,7 +90,11 @@ private:
     TimedQueue<BulletEffect> bullet_effects;
     TimedQueue<DamageEffect> damage_effects;
 
+    //! The most damage numbers shown at once, after which the oldest ones
+    //! make room.
+    static constexpr std::size_t MAX_DAMAGE_NUMBERS = 256;
+
     std::vector<BulletEffect> bullets;
-    std::vector<DamageNumber> damage_numbers;
+    FixedPool<DamageNumber, MAX_DAMAGE_NUMBERS> damage_numbers;
 };
 } // namespace jrc
@@ -21,6 +21,8 @@
 #include "nlnx/node.hpp"
 #include "nlnx/nx.hpp"
 
+#include <charconv>
+
 namespace jrc
 {
 DamageNumber::DamageNumber(Type t,
@@ -33,22 +35,16 @@ DamageNumber::DamageNumber(Type t,
     if (damage > 0) {
         miss = false;
 
-        std::string number = std::to_string(damage);
-        first_num = number[0];
-        if (number.length() > 1) {
-            rest_num = number.substr(1);
-            multiple = true;
-        } else {
-            rest_num = "";
-            multiple = false;
-        }
+        auto [end, _] = std::to_chars(
+            digits.data(), digits.data() + digits.size(), damage);
+        num_digits = static_cast<std::uint8_t>(end - digits.data());
 
-        std::int16_t total = get_advance(first_num, true);
-        for (std::size_t i = 0; i < rest_num.length(); ++i) {
-            char c = rest_num[i];
+        std::int16_t total = get_advance(digits[0], true);
+        for (std::size_t i = 1; i < num_digits; ++i) {
+            char c = digits[i];
             std::int16_t advance;
-            if (i < rest_num.length() - 1) {
-                char n = rest_num[i + 1];
+            if (i < num_digits - 1u) {
+                char n = digits[i + 1];
                 advance = (get_advance(c, false) + get_advance(n, false)) / 2;
             } else {
                 advance = get_advance(c, false);
@@ -59,6 +55,7 @@ DamageNumber::DamageNumber(Type t,
     } else {
         shift = charsets[type][true].get_w('M') / static_cast<std::int16_t>(2);
         miss = true;
+        num_digits = 0;
     }
 
     move_obj.set_x(x);
@@ -67,7 +64,10 @@ DamageNumber::DamageNumber(Type t,
     opacity.set(1.5f);
 }
 
-DamageNumber::DamageNumber() noexcept = default;
+DamageNumber::DamageNumber() noexcept
+    : type{NORMAL}, miss{true}, digits{}, num_digits{0}, shift{0}
+{
+}
 
 void DamageNumber::draw(double viewx, double viewy, float alpha) const
 {
@@ -78,29 +78,25 @@ void DamageNumber::draw(double viewx, double viewy, float alpha) const
     if (miss) {
         charsets[type][true].draw('M', {position, interopc});
     } else {
-        charsets[type][false].draw(first_num, {position, interopc});
-
-        if (multiple) {
-            std::int16_t first_advance = get_advance(first_num, true);
-            position.shift_x(first_advance);
-
-            for (std::size_t i = 0; i < rest_num.length(); ++i) {
-                char c = rest_num[i];
-                Point<std::int16_t> yshift = {0, i % 2 ? -2 : 2};
-                charsets[type][true].draw(c, {position + yshift, interopc});
-
-                std::int16_t advance;
-                if (i < rest_num.length() - 1) {
-                    char n = rest_num[i + 1];
-                    std::int16_t c_advance = get_advance(c, false);
-                    std::int16_t n_advance = get_advance(n, false);
-                    advance = (c_advance + n_advance) >> 1;
-                } else {
-                    advance = get_advance(c, false);
-                }
-
-                position.shift_x(advance);
+        charsets[type][false].draw(digits[0], {position, interopc});
+        position.shift_x(get_advance(digits[0], true));
+
+        for (std::size_t i = 1; i < num_digits; ++i) {
+            char c = digits[i];
+            Point<std::int16_t> yshift = {0, i % 2 ? 2 : -2};
+            charsets[type][true].draw(c, {position + yshift, interopc});
+
+            std::int16_t advance;
+            if (i < num_digits - 1u) {
+                char n = digits[i + 1];
+                std::int16_t c_advance = get_advance(c, false);
+                std::int16_t n_advance = get_advance(n, false);
+                advance = (c_advance + n_advance) >> 1;
+            } else {
+                advance = get_advance(c, false);
             }
+
+            position.shift_x(advance);
         }
     }
 }
@@ -49,12 +49,14 @@ private:
     std::int16_t get_advance(char c, bool first) const;
 
     static constexpr const std::uint16_t FADE_TIME = 500;
+    //! Enough for any positive `std::int32_t`.
+    static constexpr const std::size_t MAX_DIGITS = 10;
 
     Type type;
     bool miss;
-    bool multiple;
-    std::int8_t first_num;
-    std::string rest_num;
+    //! The decimal digits of the damage, as characters.
+    std::array<char, MAX_DIGITS> digits;
+    std::uint8_t num_digits;
     std::int16_t shift;
     MovingObject move_obj;
     Linear<float> opacity;
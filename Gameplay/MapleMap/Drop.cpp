@@ -36,7 +36,8 @@ Drop::Drop(std::int32_t id,
 
     angle.set(0.0f);
     opacity.set(1.0f);
-    moved = 0.0f;
+    covered = false;
+    settled = false;
     looter = nullptr;
 
     switch (mode) {
@@ -61,7 +62,10 @@ Drop::Drop(std::int32_t id,
 
 std::int8_t Drop::update(const Physics& physics)
 {
-    physics.move_object(ph_obj);
+    // Settled drops only float in place, which needs no physics.
+    if (state != FLOATING) {
+        physics.move_object(ph_obj);
+    }
 
     if (state == DROPPED) {
         if (ph_obj.on_ground) {
@@ -77,8 +81,12 @@ std::int8_t Drop::update(const Physics& physics)
     }
 
     if (state == FLOATING) {
-        ph_obj.y = basey + 5.0f + (cos(moved) - 1.0f) * 2.5f;
-        moved = (moved < 360.0f) ? moved + 0.025f : 0.0f;
+        if (!settled) {
+            physics.get_fht().update_fh(ph_obj);
+            settled = true;
+        }
+
+        ph_obj.y = basey + 5.0f + (cos(floating) - 1.0f) * 2.5f;
     }
 
     if (state == PICKEDUP) {
@@ -122,10 +130,27 @@ void Drop::expire(std::int8_t type, const PhysicsObject* lt)
     }
 }
 
+bool Drop::is_settled() const
+{
+    return state == FLOATING;
+}
+
+void Drop::set_covered(bool c)
+{
+    covered = c;
+}
+
+void Drop::update_floating()
+{
+    floating = (floating < 360.0) ? floating + 0.025 : 0.0;
+}
+
 Rectangle<std::int16_t> Drop::bounds() const
 {
     auto lt = get_position();
     auto rb = lt + Point<std::int16_t>(32, 32);
     return Rectangle<std::int16_t>(lt, rb);
 }
+
+double Drop::floating = 0.0;
 } // namespace jrc
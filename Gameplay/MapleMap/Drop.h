@@ -32,6 +32,18 @@ public:
 
     Rectangle<std::int16_t> bounds() const;
 
+    //! Check whether the drop has settled and floats in place.
+    bool is_settled() const;
+    //! Identify the icon, so that settled drops which show the same icon on
+    //! the same spot can be drawn once.
+    virtual const void* get_icon() const = 0;
+    //! Set whether an identical drop is drawn on top of this one, so that
+    //! this one need not be drawn.
+    void set_covered(bool covered);
+
+    //! Advance the floating of all settled drops by a timestep.
+    static void update_floating();
+
 protected:
     Drop(std::int32_t oid,
          std::int32_t owner,
@@ -43,6 +55,7 @@ protected:
 
     Linear<float> opacity;
     Linear<float> angle;
+    bool covered;
 
 private:
     enum State { DROPPED, FLOATING, PICKEDUP };
@@ -56,6 +69,11 @@ private:
 
     Point<std::int16_t> dest;
     double basey;
-    double moved;
+    //! Whether the foothold has been found since the drop settled.
+    bool settled;
+
+    //! Shared by all drops, so that drops which settled on the same spot
+    //! float in step.
+    static double floating;
 };
 } // namespace jrc
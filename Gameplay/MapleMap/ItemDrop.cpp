@@ -34,10 +34,15 @@ ItemDrop::ItemDrop(std::int32_t oid,
 
 void ItemDrop::draw(double viewx, double viewy, float alpha) const
 {
-    if (!active)
+    if (!active || covered)
         return;
 
     Point<std::int16_t> absp = ph_obj.get_absolute(viewx, viewy, alpha);
     icon.draw({angle.get(alpha), absp, opacity.get(alpha)});
 }
+
+const void* ItemDrop::get_icon() const
+{
+    return &icon;
+}
 } // namespace jrc
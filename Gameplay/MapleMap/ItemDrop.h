@@ -35,6 +35,7 @@ public:
              const Texture& icon);
 
     void draw(double viewx, double viewy, float alpha) const override;
+    const void* get_icon() const override;
 
 private:
     const Texture& icon;
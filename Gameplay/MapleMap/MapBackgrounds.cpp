@@ -125,15 +125,11 @@ void Background::draw(double viewx, double viewy, float alpha) const
     auto ix = static_cast<std::int16_t>(std::round(x));
     auto iy = static_cast<std::int16_t>(std::round(y));
 
-    std::int16_t tw = cx * htile;
-    std::int16_t th = cy * vtile;
-    for (std::int16_t tx = 0; tx < tw; tx += cx) {
-        for (std::int16_t ty = 0; ty < th; ty += cy) {
-            animation.draw(DrawArgument(Point<std::int16_t>(ix + tx, iy + ty),
-                                        flipped,
-                                        opacity / 255),
-                           alpha);
-        }
+    DrawArgument args{Point<std::int16_t>(ix, iy), flipped, opacity / 255};
+    if (htile > 1 || vtile > 1) {
+        animation.draw_tiled(args, {cx, cy}, {htile, vtile}, alpha);
+    } else {
+        animation.draw(args, alpha);
     }
 }
 
@@ -27,7 +27,8 @@ void MapChars::draw(Layer::Id layer,
     chars.draw(layer, viewx, viewy, alpha);
 }
 
-void MapChars::update(const Physics& physics)
+void MapChars::update(const Physics& physics,
+                      const Rectangle<std::int16_t>& view)
 {
     for (; !spawns.empty(); spawns.pop()) {
         const CharSpawn& spawn = spawns.front();
@@ -40,7 +41,7 @@ void MapChars::update(const Physics& physics)
         }
     }
 
-    chars.update(physics);
+    chars.update(physics, view);
 }
 
 void MapChars::spawn(CharSpawn&& spawn)
@@ -31,8 +31,8 @@ class MapChars
 public:
     // Draw all characters on a layer.
     void draw(Layer::Id layer, double viewx, double viewy, float alpha) const;
-    // Update all characters.
-    void update(const Physics& physics);
+    // Update all characters. Those outside of `view` are updated coarsely.
+    void update(const Physics& physics, const Rectangle<std::int16_t>& view);
 
     // Spawn a new character, if it has not been spawned yet.
     void spawn(CharSpawn&& spawn);
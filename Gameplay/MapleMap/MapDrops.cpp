@@ -68,20 +68,42 @@ void MapDrops::update(const Physics& physics)
                                               ? BUNDLE
                                               : (itemid > 49) ? GOLD : BRONZE;
                 const Animation& icon = mesoicons[mesotype];
-                drops.add(spawn.instantiate(icon));
+                spawned.push_back(spawn.instantiate(icon));
             } else if (const ItemData& itemdata = ItemData::get(itemid)) {
                 const Texture& icon = itemdata.get_icon(true);
-                drops.add(spawn.instantiate(icon));
+                spawned.push_back(spawn.instantiate(icon));
             }
         }
     }
 
+    if (!spawned.empty()) {
+        drops.add(std::move(spawned));
+        spawned.clear();
+    }
+
     for (auto& mesoicon : mesoicons) {
         mesoicon.update();
     }
 
+    Drop::update_floating();
     drops.update(physics);
 
+    drop_cells.clear();
+    stacks.clear();
+    for (auto& mmo : drops) {
+        if (nullable_ptr<Drop> drop = mmo.second.get()) {
+            drop_cells.insert(drop->bounds(), mmo.first);
+
+            // Settled drops float in step, so identical ones on the same
+            // spot would be drawn over each other.
+            bool covered = drop->is_settled()
+                           && !stacks.insert({drop->get_icon(),
+                                              drop->get_position()})
+                                   .second;
+            drop->set_covered(covered);
+        }
+    }
+
     lootenabled = true;
 }
 
@@ -102,6 +124,8 @@ void MapDrops::remove(std::int32_t oid,
 void MapDrops::clear()
 {
     drops.clear();
+    drop_cells = {};
+    stacks.clear();
 }
 
 MapDrops::Loot MapDrops::find_loot_at(Point<std::int16_t> playerpos)
@@ -109,12 +133,11 @@ MapDrops::Loot MapDrops::find_loot_at(Point<std::int16_t> playerpos)
     if (!lootenabled)
         return {0, {}};
 
-    for (auto& mmo : drops) {
-        nullable_ptr<const Drop> drop = mmo.second.get();
+    for (std::int32_t oid : drop_cells.at(playerpos)) {
+        nullable_ptr<const Drop> drop = drops.get(oid);
         if (drop && drop->bounds().contains(playerpos)) {
             lootenabled = false;
 
-            std::int32_t oid = mmo.first;
             Point<std::int16_t> position = drop->get_position();
             return {oid, position};
         }
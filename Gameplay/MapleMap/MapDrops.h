@@ -17,11 +17,15 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "../../Graphics/Animation.h"
+#include "../../Template/SpatialHash.h"
 #include "../Spawn.h"
 #include "MapObjects.h"
 
 #include <array>
+#include <memory>
 #include <queue>
+#include <unordered_set>
+#include <vector>
 
 namespace jrc
 {
@@ -52,6 +56,36 @@ public:
 
 private:
     MapObjects drops;
+    // Drop oids by where they can be picked up, as of the last update.
+    SpatialHash<std::int32_t> drop_cells;
+
+    // An icon on a spot, where settled drops showing the same icon are
+    // drawn only once.
+    struct Stack {
+        const void* icon;
+        Point<std::int16_t> position;
+
+        bool operator==(const Stack& other) const
+        {
+            return icon == other.icon && position == other.position;
+        }
+    };
+
+    struct StackHash {
+        std::size_t operator()(const Stack& stack) const
+        {
+            auto x = static_cast<std::uint16_t>(stack.position.x());
+            auto y = static_cast<std::uint16_t>(stack.position.y());
+            std::size_t spot = static_cast<std::size_t>(x) << 16 | y;
+
+            return std::hash<const void*>{}(stack.icon) ^ spot;
+        }
+    };
+
+    // The stacks of settled drops seen in the last update.
+    std::unordered_set<Stack, StackHash> stacks;
+    // Drops spawned in the same update, added to the map together.
+    std::vector<std::unique_ptr<MapObject>> spawned;
 
     enum MesoIcon { BRONZE, GOLD, BUNDLE, BAG, NUM_ICONS };
     std::array<Animation, NUM_ICONS> mesoicons;
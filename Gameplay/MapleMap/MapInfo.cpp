@@ -54,11 +54,12 @@ MapInfo::MapInfo(nl::node src,
     town = info["town"].get_bool();
 
     for (auto&& seat : src["seat"]) {
-        seats.push_back(seat);
+        seat_cells.insert(seats.emplace_back(seat).bounds(), seats.size() - 1);
     }
 
     for (auto&& ladder : src["ladderRope"]) {
-        ladders.push_back(ladder);
+        ladder_cells.insert(ladders.emplace_back(ladder).bounds(),
+                            ladders.size() - 1);
     }
 }
 
@@ -86,7 +87,8 @@ Range<std::int16_t> MapInfo::get_borders() const
 
 nullable_ptr<const Seat> MapInfo::find_seat(Point<std::int16_t> position) const
 {
-    for (auto& seat : seats) {
+    for (std::size_t index : seat_cells.at(position)) {
+        const Seat& seat = seats[index];
         if (seat.in_range(position)) {
             return seat;
         }
@@ -97,7 +99,8 @@ nullable_ptr<const Seat> MapInfo::find_seat(Point<std::int16_t> position) const
 nullable_ptr<const Ladder> MapInfo::find_ladder(Point<std::int16_t> position,
                                                 bool upwards) const
 {
-    for (auto& ladder : ladders) {
+    for (std::size_t index : ladder_cells.at(position)) {
+        const Ladder& ladder = ladders[index];
         if (ladder.in_range(position, upwards)) {
             return ladder;
         }
@@ -122,6 +125,12 @@ Point<std::int16_t> Seat::get_pos() const
     return pos;
 }
 
+Rectangle<std::int16_t> Seat::bounds() const
+{
+    return {pos - Point<std::int16_t>(10, 10),
+            pos + Point<std::int16_t>(10, 10)};
+}
+
 Ladder::Ladder(nl::node src)
 {
     x = src["x"];
@@ -153,4 +162,13 @@ std::int16_t Ladder::get_x() const
 {
     return x;
 }
+
+Rectangle<std::int16_t> Ladder::bounds() const
+{
+    // Covers the positions checked when climbing both up and down.
+    return {static_cast<std::int16_t>(x - 10),
+            static_cast<std::int16_t>(x + 10),
+            static_cast<std::int16_t>(y1 - 5),
+            static_cast<std::int16_t>(y2 + 5)};
+}
 } // namespace jrc
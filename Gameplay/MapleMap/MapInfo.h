@@ -18,6 +18,7 @@
 #pragma once
 #include "../../Template/Point.h"
 #include "../../Template/Range.h"
+#include "../../Template/SpatialHash.h"
 #include "../../Template/nullable_ptr.h"
 #include "nlnx/node.hpp"
 
@@ -32,6 +33,8 @@ public:
 
     bool in_range(Point<std::int16_t> position) const;
     Point<std::int16_t> get_pos() const;
+    //! The area within which the seat is in range.
+    Rectangle<std::int16_t> bounds() const;
 
 private:
     Point<std::int16_t> pos;
@@ -46,6 +49,8 @@ public:
     bool in_range(Point<std::int16_t> position, bool upwards) const;
     bool fell_off(std::int16_t y, bool downwards) const;
     std::int16_t get_x() const;
+    //! The area within which the ladder is in range.
+    Rectangle<std::int16_t> bounds() const;
 
 private:
     std::int16_t x;
@@ -89,5 +94,8 @@ private:
     Range<std::int16_t> map_borders;
     std::vector<Seat> seats;
     std::vector<Ladder> ladders;
+    //! Indices into `seats` and `ladders` by where they are in range.
+    SpatialHash<std::size_t> seat_cells;
+    SpatialHash<std::size_t> ladder_cells;
 };
 } // namespace jrc
@@ -17,11 +17,13 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "MapMobs.h"
 
+#include "../../Util/Profiler.h"
 #include "Mob.h"
 
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <utility>
 
 namespace jrc
 {
@@ -33,7 +35,8 @@ void MapMobs::draw(Layer::Id layer,
     mobs.draw(layer, viewx, viewy, alpha);
 }
 
-void MapMobs::update(const Physics& physics)
+void MapMobs::update(const Physics& physics,
+                     const Rectangle<std::int16_t>& view)
 {
     for (; !spawns.empty(); spawns.pop()) {
         const MobSpawn& spawn = spawns.front();
@@ -46,10 +49,12 @@ void MapMobs::update(const Physics& physics)
             mob->activate();
         } else {
             mobs.add(spawn.instantiate());
+            hitboxes.add({spawn.get_oid(), nullptr});
         }
     }
 
-    mobs.update(physics);
+    mobs.update(physics, view);
+    update_hitboxes();
 }
 
 void MapMobs::spawn(MobSpawn&& spawn)
@@ -67,6 +72,7 @@ void MapMobs::remove(std::int32_t oid, std::int8_t animation)
 void MapMobs::clear()
 {
     mobs.clear();
+    hitboxes.clear();
 }
 
 void MapMobs::set_control(std::int32_t oid, bool control)
@@ -97,6 +103,8 @@ void MapMobs::send_movement(std::int32_t oid,
 
 AttackResult MapMobs::send_attack(const Attack& attack)
 {
+    JOURNEY_ZONE("MapMobs::send_attack");
+
     Point<std::int16_t> origin = attack.origin;
     Rectangle<std::int16_t> range = attack.range;
     std::int16_t h_range
@@ -146,6 +154,32 @@ void MapMobs::apply_damage(std::int32_t oid,
     }
 }
 
+void MapMobs::update_hitboxes()
+{
+    hitboxes.refresh(
+        [this](Target& target, Rectangle<std::int16_t>& bounds) {
+            nullable_ptr<const MapObject> mmo
+                = std::as_const(mobs).get(target.oid);
+            if (!mmo) {
+                return false;
+            }
+
+            target.mob = static_cast<const Mob*>(mmo.get());
+            bounds = target.mob->get_hitbox();
+            return true;
+        });
+}
+
+template<typename Visitor>
+void MapMobs::visit_in_range(Rectangle<std::int16_t> range,
+                             Visitor&& visit) const
+{
+    hitboxes.visit(range, [&visit](const Target& target) {
+        const Mob& mob = *target.mob;
+        return !mob.is_alive() || visit(mob);
+    });
+}
+
 boost::container::flat_map<std::uint16_t, std::int32_t>
 MapMobs::find_closest(Rectangle<std::int16_t> range,
                       Point<std::int16_t> origin,
@@ -157,19 +191,17 @@ MapMobs::find_closest(Rectangle<std::int16_t> range,
     if (mob_count == 1) {
         auto closest_oid = std::numeric_limits<std::int32_t>::lowest();
         auto closest_distance = std::numeric_limits<std::uint16_t>::max();
-        for (const auto& mmo : mobs) {
-            auto mob = static_cast<const Mob*>(mmo.second.get());
-            if (mob && mob->is_alive() && mob->is_in_range(range)) {
-                std::int32_t oid = mob->get_oid();
-                auto distance = static_cast<std::uint16_t>(
-                    mob->get_position().disp(origin));
-
-                if (distance < closest_distance) {
-                    closest_distance = distance;
-                    closest_oid = oid;
-                }
+        visit_in_range(range, [&](const Mob& mob) {
+            auto distance
+                = static_cast<std::uint16_t>(mob.get_position().disp(origin));
+
+            if (distance < closest_distance) {
+                closest_distance = distance;
+                closest_oid = mob.get_oid();
             }
-        }
+
+            return true;
+        });
 
         if (closest_oid == std::numeric_limits<std::int32_t>::lowest()) {
             return {};
@@ -181,21 +213,19 @@ MapMobs::find_closest(Rectangle<std::int16_t> range,
     boost::container::flat_map<std::uint16_t, std::int32_t> targets;
     targets.reserve(mob_count + 1);
 
-    for (const auto& mmo : mobs) {
-        auto mob = static_cast<const Mob*>(mmo.second.get());
-        if (mob && mob->is_alive() && mob->is_in_range(range)) {
-            std::int32_t oid = mob->get_oid();
-            auto distance
-                = static_cast<std::uint16_t>(mob->get_position().disp(origin));
-            targets.emplace(distance, oid);
+    visit_in_range(range, [&](const Mob& mob) {
+        auto distance
+            = static_cast<std::uint16_t>(mob.get_position().disp(origin));
+        targets.emplace(distance, mob.get_oid());
 
-            if (targets.size() > mob_count) {
-                auto furthest = targets.end();
-                --furthest;
-                targets.erase(furthest);
-            }
+        if (targets.size() > mob_count) {
+            auto furthest = targets.end();
+            --furthest;
+            targets.erase(furthest);
         }
-    }
+
+        return true;
+    });
 
     return targets;
 }
@@ -207,6 +237,8 @@ bool MapMobs::contains(std::int32_t oid) const
 
 std::int32_t MapMobs::find_colliding(const MovingObject& moveobj) const
 {
+    JOURNEY_ZONE("MapMobs::find_colliding");
+
     Range<std::int16_t> horizontal{moveobj.get_last_x(), moveobj.get_x()};
     Range<std::int16_t> vertical{moveobj.get_last_y(), moveobj.get_y()};
     Rectangle<std::int16_t> player_rect{horizontal.smaller(),
@@ -215,17 +247,13 @@ std::int32_t MapMobs::find_colliding(const MovingObject& moveobj) const
                                             - static_cast<std::int16_t>(50),
                                         vertical.greater()};
 
-    auto iter
-        = std::find_if(mobs.begin(), mobs.end(), [player_rect](auto& mmo) {
-              nullable_ptr<Mob> mob = mmo.second.get();
-              return mob && mob->is_alive() && mob->is_in_range(player_rect);
-          });
-
-    if (iter == mobs.end()) {
-        return 0;
-    }
+    std::int32_t colliding = 0;
+    visit_in_range(player_rect, [&colliding](const Mob& mob) {
+        colliding = mob.get_oid();
+        return false;
+    });
 
-    return iter->second->get_oid();
+    return colliding;
 }
 
 MobAttack MapMobs::create_attack(std::int32_t oid) const
@@ -16,6 +16,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include "../../Template/SweepList.h"
 #include "../Combat/Attack.h"
 #include "../Combat/SpecialMove.h"
 #include "../Spawn.h"
@@ -23,17 +24,20 @@
 #include "boost/container/flat_map.hpp"
 
 #include <queue>
+#include <vector>
 
 namespace jrc
 {
+class Mob;
+
 //! A collection of mobs on a map.
 class MapMobs
 {
 public:
     //! Draw all mobs on a layer.
     void draw(Layer::Id layer, double viewx, double viewy, float alpha) const;
-    //! Update all mobs.
-    void update(const Physics& physics);
+    //! Update all mobs. Those outside of `view` are updated coarsely.
+    void update(const Physics& physics, const Rectangle<std::int16_t>& view);
 
     //! Spawn a new mob.
     void spawn(MobSpawn&& spawn);
@@ -74,13 +78,30 @@ public:
     Point<std::int16_t> get_mob_head_position(std::int32_t oid) const;
 
 private:
+    //! A mob which can be hit, looked up again after every update.
+    struct Target {
+        std::int32_t oid;
+        const Mob* mob;
+    };
+
     [[nodiscard]] boost::container::flat_map<std::uint16_t, std::int32_t>
     find_closest(Rectangle<std::int16_t> range,
                  Point<std::int16_t> origin,
                  std::uint8_t mob_count) const noexcept;
 
+    //! Move the hitboxes along with the mobs, and drop those of removed
+    //! mobs.
+    void update_hitboxes();
+    //! Call `visit` with every live mob in the range, until it returns
+    //! false. Only the hitboxes near the range are looked at.
+    template<typename Visitor>
+    void visit_in_range(Rectangle<std::int16_t> range, Visitor&& visit) const;
+
     MapObjects mobs;
 
     std::queue<MobSpawn> spawns;
+
+    //! Where mobs could be hit, as of the last update.
+    SweepList<Target> hitboxes;
 };
 } // namespace jrc
@@ -30,7 +30,8 @@ void MapNpcs::draw(Layer::Id layer,
     npcs.draw(layer, viewx, viewy, alpha);
 }
 
-void MapNpcs::update(const Physics& physics)
+void MapNpcs::update(const Physics& physics,
+                     const Rectangle<std::int16_t>& view)
 {
     for (; !spawns.empty(); spawns.pop()) {
         const NpcSpawn& spawn = spawns.front();
@@ -44,7 +45,7 @@ void MapNpcs::update(const Physics& physics)
         }
     }
 
-    npcs.update(physics);
+    npcs.update(physics, view);
 }
 
 void MapNpcs::spawn(NpcSpawn&& spawn)
@@ -29,8 +29,8 @@ class MapNpcs
 public:
     //! Draw all NPCs on a layer.
     void draw(Layer::Id layer, double viewx, double viewy, float alpha) const;
-    //! Update all NPCs.
-    void update(const Physics& physics);
+    //! Update all NPCs. Those outside of `view` are updated coarsely.
+    void update(const Physics& physics, const Rectangle<std::int16_t>& view);
 
     //! Add an NPC to the spawn queue.
     void spawn(NpcSpawn&& spawn);
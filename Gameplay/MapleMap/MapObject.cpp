@@ -19,7 +19,8 @@
 
 namespace jrc
 {
-MapObject::MapObject(std::int32_t o, Point<std::int16_t> p) : oid(o)
+MapObject::MapObject(std::int32_t o, Point<std::int16_t> p)
+    : oid(o), skipped_steps(0)
 {
     set_position(p);
     active = true;
@@ -31,6 +32,17 @@ std::int8_t MapObject::update(const Physics& physics)
     return ph_obj.fh_layer;
 }
 
+std::int8_t MapObject::update_far(const Physics& physics, std::uint16_t)
+{
+    physics.move_object(ph_obj);
+    return ph_obj.fh_layer;
+}
+
+bool MapObject::needs_full_update() const
+{
+    return false;
+}
+
 void MapObject::set_position(std::int16_t x, std::int16_t y)
 {
     ph_obj.set_x(x);
@@ -33,6 +33,13 @@ public:
 
     //! Updates the object and returns the updated layer.
     virtual std::int8_t update(const Physics& physics);
+    //! Updates the object coarsely in place of `steps` calls to update(),
+    //! while it is far out of view. Returns the updated layer.
+    virtual std::int8_t update_far(const Physics& physics,
+                                   std::uint16_t steps);
+    //! Checks whether this object has to be updated every timestep even
+    //! while it is out of view.
+    virtual bool needs_full_update() const;
     //! Reactivates the object.
     virtual void activate();
     //! Deactivates the object.
@@ -58,5 +65,11 @@ protected:
     PhysicsObject ph_obj;
     std::int32_t oid;
     bool active;
+
+private:
+    friend class MapObjects;
+
+    //! Timesteps which passed without an update while out of view.
+    std::uint16_t skipped_steps;
 };
 } // namespace jrc
@@ -34,11 +34,25 @@ void MapObjects::draw(Layer::Id layer,
 
 void MapObjects::update(const Physics& physics)
 {
+    update_objects(physics, nullptr);
+}
+
+void MapObjects::update(const Physics& physics,
+                        const Rectangle<std::int16_t>& view)
+{
+    update_objects(physics, &view);
+}
+
+void MapObjects::update_objects(const Physics& physics,
+                                const Rectangle<std::int16_t>* view)
+{
+    ++ticks;
+
     for (auto iter = objects.begin(); iter != objects.end();) {
         bool remove_mob = false;
         if (auto& mmo = iter->second) {
             std::int8_t oldlayer = mmo->get_layer();
-            std::int8_t newlayer = mmo->update(physics);
+            std::int8_t newlayer = update_object(*mmo, physics, view);
             if (newlayer == -1) {
                 remove_mob = true;
             } else if (newlayer != oldlayer) {
@@ -58,6 +72,40 @@ void MapObjects::update(const Physics& physics)
     }
 }
 
+std::int8_t
+MapObjects::update_object(MapObject& mmo,
+                          const Physics& physics,
+                          const Rectangle<std::int16_t>* view) const
+{
+    if (!view || view->contains(mmo.get_position())
+        || mmo.needs_full_update()) {
+        if (mmo.skipped_steps > 0) {
+            // Catch up on the timesteps skipped while out of view.
+            std::int8_t layer = mmo.update_far(physics, mmo.skipped_steps);
+            mmo.skipped_steps = 0;
+
+            if (layer == -1) {
+                return layer;
+            }
+        }
+
+        return mmo.update(physics);
+    }
+
+    ++mmo.skipped_steps;
+
+    // Spread the objects out of view over the timesteps by their oids.
+    if (mmo.skipped_steps < FAR_STEPS
+        && (ticks + mmo.get_oid()) % FAR_STEPS != 0) {
+        return mmo.get_layer();
+    }
+
+    std::int8_t layer = mmo.update_far(physics, mmo.skipped_steps);
+    mmo.skipped_steps = 0;
+
+    return layer;
+}
+
 void MapObjects::clear()
 {
     objects.clear();
@@ -80,6 +128,15 @@ void MapObjects::add(std::unique_ptr<MapObject> toadd)
     layers[layer].insert(oid);
 }
 
+void MapObjects::add(std::vector<std::unique_ptr<MapObject>>&& toadd)
+{
+    objects.reserve(objects.size() + toadd.size());
+
+    for (auto& mapobject : toadd) {
+        add(std::move(mapobject));
+    }
+}
+
 void MapObjects::remove(std::int32_t oid)
 {
     auto iter = objects.find(oid);
@@ -16,6 +16,7 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include "../../Template/Rectangle.h"
 #include "../../Template/nullable_ptr.h"
 #include "Layer.h"
 #include "MapObject.h"
@@ -24,6 +25,7 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace jrc
 {
@@ -36,9 +38,14 @@ public:
     //! Update all mapobjects of this type. Also updates layers eg. drawing
     //! order.
     void update(const Physics& physics);
+    //! Update all mapobjects of this type, but those which are outside of
+    //! `view` only coarsely and once every few timesteps.
+    void update(const Physics& physics, const Rectangle<std::int16_t>& view);
 
     //! Adds a mapobject of this type.
     void add(std::unique_ptr<MapObject> mapobject);
+    //! Adds several mapobjects of this type at once.
+    void add(std::vector<std::unique_ptr<MapObject>>&& mapobjects);
     //! Removes the mapobject with the given oid.
     void remove(std::int32_t oid);
     //! Removes all mapobjects of this type.
@@ -65,7 +72,19 @@ public:
     underlying_t::const_iterator end() const;
 
 private:
+    void update_objects(const Physics& physics,
+                        const Rectangle<std::int16_t>* view);
+    //! Update a single mapobject and return its new layer.
+    std::int8_t update_object(MapObject& mmo,
+                              const Physics& physics,
+                              const Rectangle<std::int16_t>* view) const;
+
+    //! How many timesteps apart mapobjects out of view are updated.
+    static constexpr std::uint16_t FAR_STEPS = 8;
+
     std::unordered_map<std::int32_t, std::unique_ptr<MapObject>> objects;
     std::array<std::unordered_set<std::int32_t>, Layer::LENGTH> layers;
+    //! Counts timesteps, to spread the updates of mapobjects out of view.
+    std::uint16_t ticks = 0;
 };
 } // namespace jrc
@@ -42,15 +42,19 @@ MapPortals::MapPortals(nl::node src, std::int32_t map_id)
         bool intramap = target_id == map_id;
 
         portal_ids_by_name.emplace(std::string{name}, portal_id);
-        portals_by_id.emplace(std::piecewise_construct,
-                              std::forward_as_tuple(portal_id),
-                              std::forward_as_tuple(animation,
-                                                    type,
-                                                    std::move(name),
-                                                    intramap,
-                                                    position,
-                                                    target_id,
-                                                    std::move(target_name)));
+        auto [iter, inserted] = portals_by_id.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(portal_id),
+            std::forward_as_tuple(animation,
+                                  type,
+                                  std::move(name),
+                                  intramap,
+                                  position,
+                                  target_id,
+                                  std::move(target_name)));
+        if (inserted) {
+            portal_cells.insert(iter->second.bounds(), portal_id);
+        }
     }
 
     cooldown = WARP_CD;
@@ -66,12 +70,20 @@ void MapPortals::update(Point<std::int16_t> playerpos)
     animations[Portal::REGULAR].update(Constants::TIMESTEP);
     animations[Portal::HIDDEN].update(Constants::TIMESTEP);
 
-    for (auto& iter : portals_by_id) {
-        Portal& portal = iter.second;
+    // Only portals near the player can be touched, and the ones near it
+    // last time have to notice that it left.
+    for (std::uint8_t portal_id : nearby) {
+        portals_by_id.at(portal_id).update(playerpos);
+    }
+    nearby.clear();
+
+    for (std::uint8_t portal_id : portal_cells.at(playerpos)) {
+        Portal& portal = portals_by_id.at(portal_id);
         switch (portal.get_type()) {
         case Portal::HIDDEN:
         case Portal::TOUCH:
             portal.update(playerpos);
+            nearby.push_back(portal_id);
             break;
         default:
             break;
@@ -117,8 +129,8 @@ Portal::WarpInfo MapPortals::find_warp_at(Point<std::int16_t> playerpos)
     if (cooldown == 0) {
         cooldown = WARP_CD;
 
-        for (const auto& iter : portals_by_id) {
-            const Portal& portal = iter.second;
+        for (std::uint8_t portal_id : portal_cells.at(playerpos)) {
+            const Portal& portal = portals_by_id.at(portal_id);
             if (portal.bounds().contains(playerpos)) {
                 return portal.getwarpinfo();
             }
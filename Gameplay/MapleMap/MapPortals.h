@@ -16,11 +16,13 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include "../../Template/SpatialHash.h"
 #include "../../Template/nullable_ptr.h"
 #include "Portal.h"
 #include "nlnx/node.hpp"
 
 #include <unordered_map>
+#include <vector>
 
 namespace jrc
 {
@@ -47,6 +49,10 @@ private:
 
     std::unordered_map<std::uint8_t, Portal> portals_by_id;
     std::unordered_map<std::string, std::uint8_t> portal_ids_by_name;
+    // Portal ids by the area in which the player touches them.
+    SpatialHash<std::uint8_t> portal_cells;
+    // Hidden and touch portals which were near the player last update.
+    std::vector<std::uint8_t> nearby;
 
     static const std::int16_t WARP_CD = 48;
     std::int16_t cooldown;
@@ -33,10 +33,15 @@ MesoDrop::MesoDrop(std::int32_t oid,
 
 void MesoDrop::draw(double viewx, double viewy, float alpha) const
 {
-    if (!active)
+    if (!active || covered)
         return;
 
     Point<std::int16_t> absp = ph_obj.get_absolute(viewx, viewy, alpha);
     icon.draw({angle.get(alpha), absp, opacity.get(alpha)}, alpha);
 }
+
+const void* MesoDrop::get_icon() const
+{
+    return &icon;
+}
 } // namespace jrc
@@ -34,6 +34,7 @@ public:
              const Animation& icon);
 
     void draw(double viewx, double viewy, float alpha) const override;
+    const void* get_icon() const override;
 
 private:
     const Animation& icon;
@@ -20,8 +20,9 @@
 #include "../../Constants.h"
 #include "../../Net/Packets/GameplayPackets.h"
 #include "../../Util/Misc.h"
+#include "../../Util/NxPath.h"
 #include "../Movement.h"
-#include "nlnx/nx.hpp"
+#include "nlnx/node.hpp"
 
 #include <algorithm>
 #include <functional>
@@ -36,10 +37,9 @@ Mob::Mob(std::int32_t oid,
          bool new_spawn,
          std::int8_t tm,
          Point<std::int16_t> position)
-    : MapObject(oid)
+    : MapObject(oid), movements(position, stance)
 {
-    std::string strid = string_format::extend_id(mob_id, 7);
-    const nl::node src = nl::nx::mob[strid + ".img"];
+    const nl::node src = NodeCache::get().mob(mob_id);
 
     nl::node info = src["info"];
 
@@ -72,10 +72,9 @@ Mob::Mob(std::int32_t oid,
     animations[HIT] = src["hit1"];
     animations[DIE] = src["die1"];
 
-    name = nl::nx::string["Mob.img"][std::to_string(mob_id)]["name"]
-               .get_string();
+    name = NodeCache::get().mob_string(mob_id)["name"].get_string();
 
-    nl::node sndsrc = nl::nx::sound["Mob.img"][strid];
+    nl::node sndsrc = NodeCache::get().mob_sound(mob_id);
 
     hit_sound = sndsrc["Damage"];
     die_sound = sndsrc["Die"];
@@ -194,38 +193,56 @@ std::int8_t Mob::update(const Physics& physics)
             }
         }
 
-        switch (stance) {
-        case MOVE:
-            if (can_fly) {
-                ph_obj.h_force = flip ? fly_speed : -fly_speed;
-                switch (fly_direction) {
-                case UPWARDS:
-                    ph_obj.v_force = -fly_speed;
-                    break;
-                case DOWNWARDS:
-                    ph_obj.v_force = fly_speed;
-                    break;
-                default:
-                    break;
+        bool following = false;
+        if (!control) {
+            following = movements.is_moving();
+            movements.update();
+        }
+
+        if (following) {
+            // Go where the controlling client moved the mob, instead of
+            // guessing its movement.
+            set_stance(movements.get_stance());
+
+            Point<std::int16_t> position = movements.get_position();
+            ph_obj.hspeed = position.x() - ph_obj.crnt_x();
+            ph_obj.vspeed = position.y() - ph_obj.crnt_y();
+            ph_obj.move();
+            physics.get_fht().update_fh(ph_obj);
+        } else {
+            switch (stance) {
+            case MOVE:
+                if (can_fly) {
+                    ph_obj.h_force = flip ? fly_speed : -fly_speed;
+                    switch (fly_direction) {
+                    case UPWARDS:
+                        ph_obj.v_force = -fly_speed;
+                        break;
+                    case DOWNWARDS:
+                        ph_obj.v_force = fly_speed;
+                        break;
+                    default:
+                        break;
+                    }
+                } else {
+                    ph_obj.h_force = flip ? speed : -speed;
                 }
-            } else {
-                ph_obj.h_force = flip ? speed : -speed;
-            }
-            break;
-        case HIT:
-            if (can_move) {
-                double KBFORCE = ph_obj.on_ground ? 0.2 : 0.1;
-                ph_obj.h_force = flip ? -KBFORCE : KBFORCE;
+                break;
+            case HIT:
+                if (can_move) {
+                    double KBFORCE = ph_obj.on_ground ? 0.2 : 0.1;
+                    ph_obj.h_force = flip ? -KBFORCE : KBFORCE;
+                }
+                break;
+            case JUMP:
+                ph_obj.v_force = -5.0;
+                break;
+            default:
+                break;
             }
-            break;
-        case JUMP:
-            ph_obj.v_force = -5.0;
-            break;
-        default:
-            break;
-        }
 
-        physics.move_object(ph_obj);
+            physics.move_object(ph_obj);
+        }
 
         if (control) {
             ++counter;
@@ -257,6 +274,36 @@ std::int8_t Mob::update(const Physics& physics)
     return ph_obj.fh_layer;
 }
 
+std::int8_t Mob::update_far(const Physics& physics, std::uint16_t steps)
+{
+    if (!active) {
+        return ph_obj.fh_layer;
+    }
+
+    if (fade_in) {
+        opacity.set(1.0f);
+        fade_in = false;
+    }
+
+    bool following = movements.is_moving();
+    movements.update(steps);
+
+    if (following) {
+        set_stance(movements.get_stance());
+        set_position(movements.get_position());
+        physics.get_fht().update_fh(ph_obj);
+    } else {
+        physics.move_object(ph_obj);
+    }
+
+    return ph_obj.fh_layer;
+}
+
+bool Mob::needs_full_update() const
+{
+    return control || dying || dead || fading;
+}
+
 void Mob::next_move()
 {
     if (can_move) {
@@ -342,7 +389,13 @@ void Mob::draw(double viewx, double viewy, float alpha) const
 
 void Mob::set_control(std::int8_t mode)
 {
-    control = mode > 0;
+    bool controlled = mode > 0;
+    if (controlled != control) {
+        // Movements received before the change are out of date.
+        movements.reset(get_position(), value_of(stance, flip));
+    }
+
+    control = controlled;
     aggro = mode == 2;
 }
 
@@ -353,20 +406,9 @@ void Mob::send_movement(Point<std::int16_t> start,
         return;
     }
 
-    set_position(start);
-
-    movements = std::forward<decltype(in_movements)>(in_movements);
-
-    if (movements.empty()) {
-        return;
-    }
-
-    const Movement& lastmove = movements.front();
-
-    std::uint8_t laststance = lastmove.newstate;
-    set_stance(laststance);
-
-    ph_obj.fh_id = lastmove.fh;
+    // The mob moved on its own since the last movements ran out.
+    movements.set_position(get_position());
+    movements.push(start, in_movements);
 }
 
 Point<std::int16_t> Mob::get_head_position(Point<std::int16_t> position) const
@@ -598,9 +640,14 @@ bool Mob::is_in_range(const Rectangle<std::int16_t>& range) const
         return false;
     }
 
+    return range.overlaps(get_hitbox());
+}
+
+Rectangle<std::int16_t> Mob::get_hitbox() const
+{
     Rectangle<std::int16_t> bounds = animations.at(stance).get_bounds();
     bounds.shift(get_position());
-    return range.overlaps(bounds);
+    return bounds;
 }
 
 Point<std::int16_t> Mob::get_head_position() const
@@ -28,7 +28,7 @@
 #include "../Combat/Attack.h"
 #include "../Combat/Bullet.h"
 #include "../Combat/DamageNumber.h"
-#include "../Movement.h"
+#include "../MovementBuffer.h"
 #include "MapObject.h"
 
 #include <unordered_map>
@@ -75,6 +75,12 @@ public:
     void draw(double viewx, double viewy, float alpha) const override;
     //! Update movement and animations.
     std::int8_t update(const Physics& physics) override;
+    //! Update only the movement, while far out of view.
+    std::int8_t update_far(const Physics& physics,
+                           std::uint16_t steps) override;
+    //! Check whether the mob has to be updated every timestep, because it
+    //! is controlled or dying.
+    bool needs_full_update() const override;
 
     //! Change this mob's control mode:
     //!
@@ -111,6 +117,8 @@ public:
 
     //! Check if this mob collides with the specified rectangle.
     bool is_in_range(const Rectangle<std::int16_t>& range) const;
+    //! Return the rectangle this mob collides with.
+    Rectangle<std::int16_t> get_hitbox() const;
     //! Check if this mob is still alive.
     bool is_alive() const;
     //! Return the head position.
@@ -178,7 +186,8 @@ private:
 
     TimedBool do_show_hp;
 
-    std::vector<Movement> movements;
+    //! Movements received for the mob while another client controls it.
+    MovementBuffer movements;
     std::uint16_t counter;
 
     std::int32_t id;
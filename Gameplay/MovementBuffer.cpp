@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "MovementBuffer.h"
+
+#include "../Configuration.h"
+#include "../Constants.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace jrc
+{
+MovementBuffer::MovementBuffer(Point<std::int16_t> pos,
+                               std::uint8_t st) noexcept
+    : last{0, pos, st},
+      position{pos},
+      stance{st},
+      now{0},
+      base_delay{Configuration::get().performance.movement_delay},
+      expected_arrival{-1},
+      jitter{0.0f}
+{
+}
+
+void MovementBuffer::push(Point<std::int16_t> start,
+                          const std::vector<Movement>& movements)
+{
+    // Gaps longer than the delay can cover are pauses in movement, not
+    // jitter.
+    if (expected_arrival >= 0) {
+        auto deviation = static_cast<float>(std::abs(now - expected_arrival));
+        if (deviation < MAX_DELAY) {
+            jitter += (deviation - jitter) / 16.0f;
+        }
+    }
+
+    std::int64_t start_time = now;
+    if (samples.empty()) {
+        // Move from where playback stopped to the start over the delay.
+        last.time = now - get_delay();
+    } else if (samples.back().time - now > MAX_BACKLOG) {
+        last = samples.back();
+        last.time = now - get_delay();
+        samples.clear();
+    } else {
+        start_time = samples.back().time;
+    }
+
+    std::int64_t time = start_time;
+    Point<std::int16_t> pos = start;
+    std::uint8_t st = samples.empty() ? last.stance : samples.back().stance;
+    samples.push_back({time, pos, st});
+
+    for (const Movement& movement : movements) {
+        switch (movement.type) {
+        case Movement::_ABSOLUTE:
+        case Movement::CHAIR:
+        case Movement::JUMPDOWN:
+            pos = {movement.xpos, movement.ypos};
+            st = movement.newstate;
+            break;
+        case Movement::_RELATIVE:
+            st = movement.newstate;
+            break;
+        default:
+            break;
+        }
+
+        time += std::max<std::int16_t>(movement.duration, 0);
+        samples.push_back({time, pos, st});
+    }
+
+    expected_arrival = now + (time - start_time);
+}
+
+void MovementBuffer::push(const std::vector<Movement>& movements)
+{
+    push(samples.empty() ? last.position : samples.back().position,
+         movements);
+}
+
+void MovementBuffer::update(std::uint16_t steps)
+{
+    now += Constants::TIMESTEP * steps;
+    std::int64_t playback = now - get_delay();
+
+    while (!samples.empty() && samples.front().time <= playback) {
+        last = samples.front();
+        samples.pop_front();
+    }
+
+    if (samples.empty()) {
+        position = last.position;
+        stance = last.stance;
+        return;
+    }
+
+    const Sample& next = samples.front();
+    if (playback <= last.time) {
+        position = last.position;
+    } else {
+        float progress = static_cast<float>(playback - last.time)
+                         / static_cast<float>(next.time - last.time);
+        auto lerp = [progress](std::int16_t from, std::int16_t to) {
+            return static_cast<std::int16_t>(
+                std::round(from + (to - from) * progress));
+        };
+
+        position = {lerp(last.position.x(), next.position.x()),
+                    lerp(last.position.y(), next.position.y())};
+    }
+
+    stance = next.stance;
+}
+
+void MovementBuffer::set_position(Point<std::int16_t> pos) noexcept
+{
+    if (samples.empty()) {
+        last.position = pos;
+        position = pos;
+    }
+}
+
+void MovementBuffer::reset(Point<std::int16_t> pos,
+                           std::uint8_t st) noexcept
+{
+    samples.clear();
+    last = {now, pos, st};
+    position = pos;
+    stance = st;
+
+    // Packets from the new controller arrive on their own schedule.
+    expected_arrival = -1;
+}
+
+bool MovementBuffer::is_moving() const noexcept
+{
+    return !samples.empty();
+}
+
+Point<std::int16_t> MovementBuffer::get_position() const noexcept
+{
+    return position;
+}
+
+std::uint8_t MovementBuffer::get_stance() const noexcept
+{
+    return stance;
+}
+
+std::int64_t MovementBuffer::get_delay() const noexcept
+{
+    auto delay = base_delay + static_cast<std::int64_t>(2.0f * jitter);
+    return std::min(delay, MAX_DELAY);
+}
+} // namespace jrc
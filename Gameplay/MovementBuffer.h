@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Point.h"
+#include "Movement.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace jrc
+{
+//! Plays back the movements received for a character or mob which another
+//! client moves.
+//!
+//! Every fragment of a movement packet is kept with its duration, and the
+//! position is interpolated between them a little behind the time they
+//! arrived. That delay grows with how unevenly the packets arrive, so that
+//! the fragments do not run out before the next packet comes in.
+class MovementBuffer
+{
+public:
+    MovementBuffer(Point<std::int16_t> position, std::uint8_t stance) noexcept;
+
+    //! Add the fragments of a movement packet which starts at `start`.
+    void push(Point<std::int16_t> start,
+              const std::vector<Movement>& movements);
+    //! Add the fragments of a movement packet which continues where the
+    //! last one ended.
+    void push(const std::vector<Movement>& movements);
+
+    //! Advance by a number of timesteps.
+    void update(std::uint16_t steps = 1);
+    //! Set the position which playback starts from when no fragments are
+    //! left, after it was changed otherwise.
+    void set_position(Point<std::int16_t> position) noexcept;
+    //! Drop all fragments and stand at `position`, for when another client
+    //! starts or stops moving the object.
+    void reset(Point<std::int16_t> position, std::uint8_t stance) noexcept;
+
+    //! Whether there are fragments left to play back.
+    bool is_moving() const noexcept;
+    //! Return the position at the current playback time.
+    Point<std::int16_t> get_position() const noexcept;
+    //! Return the stance of the fragment being played back.
+    std::uint8_t get_stance() const noexcept;
+
+private:
+    struct Sample {
+        //! When the fragment ends, in milliseconds.
+        std::int64_t time;
+        Point<std::int16_t> position;
+        std::uint8_t stance;
+    };
+
+    //! Milliseconds behind the arrival time at which fragments are played.
+    std::int64_t get_delay() const noexcept;
+
+    //! The most milliseconds of playback delay.
+    static constexpr std::int64_t MAX_DELAY = 1000;
+    //! The most milliseconds of fragments waiting to be played. When more
+    //! arrive, playback skips ahead to the newest packet.
+    static constexpr std::int64_t MAX_BACKLOG = 2000;
+
+    std::deque<Sample> samples;
+    //! The last fragment which was played back completely.
+    Sample last;
+    Point<std::int16_t> position;
+    std::uint8_t stance;
+
+    std::int64_t now;
+    std::int64_t base_delay;
+    //! When the next packet would arrive if packets arrived evenly.
+    std::int64_t expected_arrival;
+    //! Smoothed difference between actual and expected arrival times.
+    float jitter;
+};
+} // namespace jrc
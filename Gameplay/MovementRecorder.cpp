@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "MovementRecorder.h"
+
+#include "../Configuration.h"
+#include "../Constants.h"
+
+#include <cstdlib>
+#include <utility>
+
+namespace jrc
+{
+MovementRecorder::MovementRecorder() noexcept
+    : elapsed{0},
+      interval{Configuration::get().performance.movement_interval}
+{
+}
+
+bool MovementRecorder::record(const PhysicsObject& phobj,
+                              std::uint8_t stance)
+{
+    Movement move{phobj, stance};
+    move.duration = Constants::TIMESTEP;
+
+    if (!last.hasmoved(move)) {
+        // Send what is left once the player stands still.
+        return !fragments.empty();
+    }
+
+    bool changed = move.newstate != last.newstate || move.fh != last.fh;
+    if (!changed && !fragments.empty()) {
+        // Compare the new position with where the last fragment would have
+        // led if extended by a timestep, scaled by its length to keep the
+        // arithmetic in integers.
+        Movement& open = fragments.back();
+        std::int32_t ticks = open.duration / Constants::TIMESTEP;
+        std::int32_t sx = start.x();
+        std::int32_t sy = start.y();
+        std::int32_t dx
+            = (move.xpos - sx) * ticks - (open.xpos - sx) * (ticks + 1);
+        std::int32_t dy
+            = (move.ypos - sy) * ticks - (open.ypos - sy) * (ticks + 1);
+
+        if (std::abs(dx) <= TOLERANCE * ticks
+            && std::abs(dy) <= TOLERANCE * ticks) {
+            open.xpos = move.xpos;
+            open.ypos = move.ypos;
+            open.lastx = move.lastx;
+            open.lasty = move.lasty;
+            open.duration += Constants::TIMESTEP;
+        } else {
+            start = {open.xpos, open.ypos};
+            fragments.push_back(move);
+        }
+    } else {
+        start = {last.xpos, last.ypos};
+        fragments.push_back(move);
+    }
+
+    last = move;
+    elapsed += Constants::TIMESTEP;
+
+    return changed || elapsed >= interval
+           || fragments.size() >= MAX_FRAGMENTS;
+}
+
+std::vector<Movement> MovementRecorder::flush()
+{
+    elapsed = 0;
+
+    std::vector<Movement> sent;
+    sent.swap(fragments);
+
+    return sent;
+}
+
+void MovementRecorder::reset(Point<std::int16_t> position)
+{
+    fragments.clear();
+    elapsed = 0;
+
+    // The foothold is unknown, so the first movement is sent right away.
+    last = {position.x(),
+            position.y(),
+            position.x(),
+            position.y(),
+            last.newstate,
+            0};
+}
+} // namespace jrc
@@ -0,0 +1,62 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Point.h"
+#include "Movement.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace jrc
+{
+//! Collects the player's movement into fragments to send to the server.
+//!
+//! Consecutive timesteps are merged into one fragment for as long as the
+//! player keeps moving along roughly a straight line with the same stance
+//! and foothold. The fragments are sent together once enough time has been
+//! collected, or right away when the stance or foothold changes.
+class MovementRecorder
+{
+public:
+    MovementRecorder() noexcept;
+
+    //! Record the player's state after a timestep. Return whether the
+    //! recorded fragments should be sent now.
+    bool record(const PhysicsObject& phobj, std::uint8_t stance);
+    //! Take the recorded fragments, oldest first.
+    std::vector<Movement> flush();
+    //! Drop the recorded fragments and continue from `position`, after the
+    //! player was placed there.
+    void reset(Point<std::int16_t> position);
+
+private:
+    //! How many pixels a fragment may stray from the recorded positions.
+    static constexpr std::int32_t TOLERANCE = 2;
+    //! The most fragments sent together.
+    static constexpr std::size_t MAX_FRAGMENTS = 32;
+
+    std::vector<Movement> fragments;
+    //! The state after the last timestep.
+    Movement last;
+    //! Where the last fragment starts.
+    Point<std::int16_t> start;
+    //! Milliseconds of movement recorded since the last flush.
+    std::uint16_t elapsed;
+    std::uint16_t interval;
+};
+} // namespace jrc
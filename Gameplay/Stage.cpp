@@ -19,11 +19,14 @@
 
 #include "../Audio/Audio.h"
 #include "../Character/SkillId.h"
+#include "../Configuration.h"
 #include "../IO/Messages.h"
 #include "../Net/Packets/AttackAndSkillPackets.h"
 #include "../Net/Packets/GameplayPackets.h"
 #include "../Util/Misc.h"
-#include "nlnx/nx.hpp"
+#include "../Util/NxPath.h"
+#include "../Util/Profiler.h"
+#include "nlnx/node.hpp"
 
 #include <iostream>
 
@@ -75,12 +78,7 @@ void Stage::clear()
 
 void Stage::load_map(std::int32_t map_id)
 {
-    std::string str_id = string_format::extend_id(map_id, 9);
-    str_id += ".img";
-
-    nl::node src
-        = nl::nx::map["Map"]["Map" + std::to_string(map_id / 100'000'000)]
-                     [str_id];
+    nl::node src = NodeCache::get().map(map_id);
 
     tiles_objs = MapTilesObjs(src);
     backgrounds = MapBackgrounds(src["back"]);
@@ -88,6 +86,22 @@ void Stage::load_map(std::int32_t map_id)
     map_info = {
         src, physics.get_fht().get_walls(), physics.get_fht().get_borders()};
     portals = MapPortals(src["portal"], map_id);
+
+    // Mobs are spawned by the server, but the map lists the ones living on
+    // it, so their sounds can be decoded while the map loads.
+    for (auto life : src["life"]) {
+        if (life["type"].get_string() != "m") {
+            continue;
+        }
+
+        auto mob_id = string_conversion::or_zero<std::int32_t>(life["id"]);
+        nl::node sounds = NodeCache::get().mob_sound(mob_id);
+        Sound::prefetch(sounds["Damage"]);
+        Sound::prefetch(sounds["Die"]);
+    }
+
+    // The animations of the previous map have been released by now.
+    AnimationData::prune();
 }
 
 void Stage::respawn(std::int8_t portal_id)
@@ -108,6 +122,8 @@ void Stage::respawn(std::int8_t portal_id)
 
 void Stage::draw(float alpha) const
 {
+    JOURNEY_ZONE("Stage::draw");
+
     if (state != ACTIVE) {
         return;
     }
@@ -134,6 +150,8 @@ void Stage::draw(float alpha) const
 
 void Stage::update()
 {
+    JOURNEY_ZONE("Stage::update");
+
     if (state != ACTIVE) {
         return;
     }
@@ -142,12 +160,34 @@ void Stage::update()
     backgrounds.update();
     tiles_objs.update();
 
-    reactors.update(physics);
-    npcs.update(physics);
-    mobs.update(physics);
-    chars.update(physics);
-    drops.update(physics);
-    player.update(physics);
+    // Objects far out of view are only updated coarsely.
+    Rectangle<std::int16_t> view = camera.visible_area(
+        Configuration::get().performance.update_margin);
+
+    {
+        JOURNEY_ZONE("MapReactors::update");
+        reactors.update(physics);
+    }
+    {
+        JOURNEY_ZONE("MapNpcs::update");
+        npcs.update(physics, view);
+    }
+    {
+        JOURNEY_ZONE("MapMobs::update");
+        mobs.update(physics, view);
+    }
+    {
+        JOURNEY_ZONE("MapChars::update");
+        chars.update(physics, view);
+    }
+    {
+        JOURNEY_ZONE("MapDrops::update");
+        drops.update(physics);
+    }
+    {
+        JOURNEY_ZONE("Player::update");
+        player.update(physics);
+    }
 
     portals.update(player.get_position());
     camera.update(player.get_position());
@@ -179,6 +219,10 @@ void Stage::check_portals()
 
     Point<std::int16_t> playerpos = player.get_position();
     Portal::WarpInfo warpinfo = portals.find_warp_at(playerpos);
+    if (warpinfo.valid) {
+        player.flush_movement();
+    }
+
     if (warpinfo.intramap) {
         Point<std::int16_t> spawnpoint
             = portals.get_portal_by_name(warpinfo.to_name);
@@ -216,6 +260,7 @@ void Stage::check_drops()
     Point<std::int16_t> playerpos = player.get_position();
     MapDrops::Loot loot = drops.find_loot_at(playerpos);
     if (loot.first) {
+        player.flush_movement();
         PickupItemPacket(loot.first, loot.second).dispatch();
     }
 }
@@ -68,6 +68,13 @@ void Frame::draw(const DrawArgument& args) const
     texture.draw(args);
 }
 
+void Frame::draw_tiled(const DrawArgument& args,
+                       Point<std::int16_t> spacing,
+                       Point<std::int16_t> count) const
+{
+    texture.draw_tiled(args, spacing, count);
+}
+
 std::uint8_t Frame::start_opacity() const
 {
     return opacities.first;
@@ -132,7 +139,7 @@ float Frame::scale_step(std::uint16_t timestep) const
     return timestep * static_cast<float>(scales.second - scales.first) / delay;
 }
 
-Animation::Animation(nl::node src) : finished(false)
+AnimationData::AnimationData(nl::node src)
 {
     bool is_texture = src.data_type() == nl::node::type::bitmap;
     if (is_texture) {
@@ -163,24 +170,59 @@ Animation::Animation(nl::node src) : finished(false)
     animated = frames.size() > 1;
     zigzag = src["zigzag"].get_bool();
     repeat = src["repeat"];
+}
+
+AnimationData::AnimationData() : animated(false), zigzag(false), repeat(0)
+{
+    frames.emplace_back();
+}
+
+std::shared_ptr<const AnimationData> AnimationData::get(nl::node src)
+{
+    std::weak_ptr<const AnimationData>& cached = cache[src];
+    std::shared_ptr<const AnimationData> shared = cached.lock();
+    if (!shared) {
+        shared = std::make_shared<const AnimationData>(src);
+        cached = shared;
+    }
+
+    return shared;
+}
+
+void AnimationData::prune()
+{
+    for (auto iter = cache.begin(); iter != cache.end();) {
+        if (iter->second.expired()) {
+            iter = cache.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+std::map<nl::node, std::weak_ptr<const AnimationData>> AnimationData::cache;
 
+Animation::Animation(nl::node src)
+    : data(AnimationData::get(src)), finished(false)
+{
     reset();
 }
 
-Animation::Animation() noexcept
-    : animated(false), zigzag(false), finished(true)
+Animation::Animation() noexcept : finished(true)
 {
-    frames.emplace_back();
+    static const auto empty = std::make_shared<const AnimationData>();
+    data = empty;
 
     reset();
 }
 
 void Animation::reset()
 {
+    const Frame& first = data->frames[0];
     frame.set(0);
-    opacity.set(frames[0].start_opacity());
-    xy_scale.set(frames[0].start_scale());
-    delay = frames[0].get_delay();
+    opacity.set(first.start_opacity());
+    xy_scale.set(first.start_scale());
+    delay = first.get_delay();
     frame_step = 1;
 }
 
@@ -193,10 +235,31 @@ void Animation::draw(const DrawArgument& args, float alpha) const
     bool modify_opc = inter_opc != 1.0f;
     bool modify_scale = inter_scale != 1.0f;
     if (modify_opc || modify_scale) {
-        frames[interframe].draw(
+        data->frames[interframe].draw(
             args + DrawArgument{inter_scale, inter_scale, inter_opc});
     } else {
-        frames[interframe].draw(args);
+        data->frames[interframe].draw(args);
+    }
+}
+
+void Animation::draw_tiled(const DrawArgument& args,
+                           Point<std::int16_t> spacing,
+                           Point<std::int16_t> count,
+                           float alpha) const
+{
+    std::int16_t interframe = frame.get(alpha);
+    float inter_opc = opacity.get(alpha) / 255.0f;
+    float inter_scale = xy_scale.get(alpha) / 100.0f;
+
+    bool modify_opc = inter_opc != 1.0f;
+    bool modify_scale = inter_scale != 1.0f;
+    if (modify_opc || modify_scale) {
+        data->frames[interframe].draw_tiled(
+            args + DrawArgument{inter_scale, inter_scale, inter_opc},
+            spacing,
+            count);
+    } else {
+        data->frames[interframe].draw_tiled(args, spacing, count);
     }
 }
 
@@ -226,10 +289,11 @@ bool Animation::update(std::uint16_t timestep)
     }
 
     if (timestep >= delay) {
+        const std::vector<Frame>& frames = data->frames;
         auto last_frame = static_cast<std::int16_t>(frames.size() - 1);
         std::int16_t next_frame;
         bool ended;
-        if (zigzag && last_frame > 0) {
+        if (data->zigzag && last_frame > 0) {
             if (frame_step == 1 && frame == last_frame) {
                 frame_step = -frame_step;
                 ended = false;
@@ -251,7 +315,7 @@ bool Animation::update(std::uint16_t timestep)
             }
         }
 
-        if (ended && repeat == -1) {
+        if (ended && data->repeat == -1) {
             finished = true;
 
             opacity.set(frames[last_frame].end_opacity());
@@ -281,6 +345,7 @@ bool Animation::update(std::uint16_t timestep)
 
 std::uint16_t Animation::get_delay(std::int16_t frame_id) const
 {
+    const std::vector<Frame>& frames = data->frames;
     return frame_id < static_cast<std::int16_t>(frames.size())
                ? frames[frame_id].get_delay()
                : 0u;
@@ -288,6 +353,7 @@ std::uint16_t Animation::get_delay(std::int16_t frame_id) const
 
 std::uint16_t Animation::get_delay_until(std::int16_t frame_id) const
 {
+    const std::vector<Frame>& frames = data->frames;
     std::uint16_t total = 0;
     for (std::int16_t i = 0; i < frame_id; ++i) {
         if (i >= static_cast<std::int16_t>(frames.size())) {
@@ -322,6 +388,6 @@ Rectangle<std::int16_t> Animation::get_bounds() const
 
 const Frame& Animation::get_frame() const
 {
-    return frames[frame.get()];
+    return data->frames[frame.get()];
 }
 } // namespace jrc
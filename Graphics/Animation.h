@@ -21,6 +21,8 @@
 #include "Texture.h"
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace jrc
@@ -33,6 +35,9 @@ public:
     Frame() noexcept;
 
     void draw(const DrawArgument& args) const;
+    void draw_tiled(const DrawArgument& args,
+                    Point<std::int16_t> spacing,
+                    Point<std::int16_t> count) const;
 
     std::uint8_t start_opacity() const;
     std::uint8_t end_opacity() const;
@@ -55,7 +60,32 @@ private:
     Point<std::int16_t> head;
 };
 
+//! The frames of an animation. The data is never changed after loading, so
+//! all animations made from the same node share it.
+struct AnimationData {
+    std::vector<Frame> frames;
+    bool animated;
+    bool zigzag;
+    std::int16_t repeat;
+
+    AnimationData(nl::node src);
+    //! A single empty frame.
+    AnimationData();
+
+    //! Return the data of an animation node, which is only loaded while
+    //! some animation uses it.
+    static std::shared_ptr<const AnimationData> get(nl::node src);
+    //! Forget the animation nodes which no animation uses anymore.
+    static void prune();
+
+private:
+    static std::map<nl::node, std::weak_ptr<const AnimationData>> cache;
+};
+
 //! Class which consists of multiple textures to make an Animation.
+//!
+//! The frames are shared, so that an animation only holds the position in
+//! them, and copying it is cheap.
 class Animation
 {
 public:
@@ -67,6 +97,12 @@ public:
     void reset();
 
     void draw(const DrawArgument& arguments, float inter) const;
+    //! Draw `count` copies of the current frame in each direction,
+    //! `spacing` pixels apart.
+    void draw_tiled(const DrawArgument& arguments,
+                    Point<std::int16_t> spacing,
+                    Point<std::int16_t> count,
+                    float inter) const;
 
     std::uint16_t get_delay(std::int16_t frame) const;
     std::uint16_t get_delay_until(std::int16_t frame) const;
@@ -78,9 +114,7 @@ public:
 private:
     const Frame& get_frame() const;
 
-    std::vector<Frame> frames;
-    bool animated;
-    bool zigzag;
+    std::shared_ptr<const AnimationData> data;
 
     Nominal<std::int16_t> frame;
     Linear<float> opacity;
@@ -88,9 +122,6 @@ private:
 
     std::uint16_t delay;
     std::int16_t frame_step;
-    float opcstep;
-
-    std::int16_t repeat;
     bool finished;
 };
 } // namespace jrc
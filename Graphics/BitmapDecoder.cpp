@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "BitmapDecoder.h"
+
+#include "../Journey.h"
+#include "../Util/BitmapCache.h"
+
+namespace jrc
+{
+BitmapDecoder::BitmapDecoder() noexcept : stopping{false}
+{
+}
+
+BitmapDecoder::~BitmapDecoder()
+{
+    stop();
+}
+
+void BitmapDecoder::start(AtlasFormat format, bool keep_gradients)
+{
+    if (worker.joinable()) {
+        return;
+    }
+
+    stopping = false;
+    worker = std::thread{&BitmapDecoder::run, this, format, keep_gradients};
+}
+
+void BitmapDecoder::enqueue(const nl::bitmap& bmp)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        requests.push_back(bmp);
+    }
+
+    queued.notify_one();
+}
+
+void BitmapDecoder::poll(std::vector<Bitmap>& bitmaps)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (finished.empty()) {
+        return;
+    }
+
+    bitmaps.insert(bitmaps.end(),
+                   std::make_move_iterator(finished.begin()),
+                   std::make_move_iterator(finished.end()));
+    finished.clear();
+}
+
+void BitmapDecoder::stop()
+{
+    if (!worker.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    queued.notify_one();
+    worker.join();
+}
+
+void BitmapDecoder::run(AtlasFormat format, bool keep_gradients)
+{
+    for (;;) {
+        nl::bitmap bmp;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            queued.wait(lock,
+                        [this] { return stopping || !requests.empty(); });
+
+            if (stopping) {
+                break;
+            }
+
+            bmp = requests.front();
+            requests.pop_front();
+        }
+
+        Bitmap bitmap{bmp.id(),
+                      static_cast<GLshort>(bmp.width()),
+                      static_cast<GLshort>(bmp.height()),
+                      format,
+                      {}};
+
+#ifdef JOURNEY_USE_XXHASH
+        const void* data = BitmapCache::get().get_data(bmp);
+#else
+        const void* data = bmp.data();
+#endif
+        if (data) {
+            // `data` points to a buffer that the next bitmap reuses.
+            const auto* bgra = static_cast<const unsigned char*>(data);
+            if (keep_gradients
+                && texture_encoding::has_gradients(bgra, bitmap.w, bitmap.h)) {
+                bitmap.format = AtlasFormat::RGBA8;
+            }
+
+            texture_encoding::encode(
+                bitmap.format, bgra, bitmap.w, bitmap.h, bitmap.pixels);
+        }
+
+        std::lock_guard<std::mutex> lock{mutex};
+        finished.push_back(std::move(bitmap));
+    }
+}
+} // namespace jrc
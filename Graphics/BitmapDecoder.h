@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "GL/glew.h"
+#include "TextureEncoding.h"
+#include "nlnx/bitmap.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jrc
+{
+//! Decompresses bitmaps on a background thread.
+//!
+//! Bitmaps are stored compressed in the NX files, and decompressing one
+//! takes longer than uploading it. nlnx decompresses into a buffer shared by
+//! all bitmaps, so the worker has to be the only thread decoding them. The
+//! worker also encodes them in the format of the atlas, or in RGBA8 for
+//! bitmaps with gradients if the atlas has a page for those.
+class BitmapDecoder
+{
+public:
+    //! A decoded bitmap, which still has to be placed in the atlas.
+    struct Bitmap {
+        std::size_t id;
+        GLshort w;
+        GLshort h;
+        //! The format of `pixels`.
+        AtlasFormat format;
+        //! Encoded pixels, or nothing if the bitmap could not be decoded.
+        std::vector<unsigned char> pixels;
+    };
+
+    BitmapDecoder() noexcept;
+    ~BitmapDecoder();
+
+    BitmapDecoder(const BitmapDecoder&) = delete;
+    BitmapDecoder& operator=(const BitmapDecoder&) = delete;
+
+    //! Start the worker, which encodes the bitmaps it decodes in `format`.
+    //! With `keep_gradients`, bitmaps which would band in `format` are
+    //! encoded in RGBA8 instead.
+    void start(AtlasFormat format, bool keep_gradients);
+    //! Decode `bmp`.
+    void enqueue(const nl::bitmap& bmp);
+    //! Move the bitmaps decoded so far to the end of `bitmaps`.
+    void poll(std::vector<Bitmap>& bitmaps);
+    void stop();
+
+private:
+    void run(AtlasFormat format, bool keep_gradients);
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::deque<nl::bitmap> requests;
+    std::vector<Bitmap> finished;
+    std::atomic<bool> stopping;
+};
+} // namespace jrc
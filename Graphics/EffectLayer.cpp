@@ -17,22 +17,25 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "EffectLayer.h"
 
+#include <algorithm>
+
 namespace jrc
 {
 void EffectLayer::draw_below(Point<std::int16_t> position, float alpha) const
 {
-    for (auto iter = effects.begin(); iter != effects.upper_bound(-1);
-         ++iter) {
-        for (auto& effect : iter->second) {
-            effect.draw(position, alpha);
+    for (const Effect& effect : effects) {
+        if (effect.get_z() >= 0) {
+            break;
         }
+
+        effect.draw(position, alpha);
     }
 }
 
 void EffectLayer::draw_above(Point<std::int16_t> position, float alpha) const
 {
-    for (auto iter = effects.upper_bound(-1); iter != effects.end(); ++iter) {
-        for (auto& effect : iter->second) {
+    for (const Effect& effect : effects) {
+        if (effect.get_z() >= 0) {
             effect.draw(position, alpha);
         }
     }
@@ -40,13 +43,7 @@ void EffectLayer::draw_above(Point<std::int16_t> position, float alpha) const
 
 void EffectLayer::update()
 {
-    for (auto& [_, effect_list] : effects) {
-        effect_list.erase(
-            std::remove_if(effect_list.begin(),
-                           effect_list.end(),
-                           [](Effect& effect) { return effect.update(); }),
-            effect_list.end());
-    }
+    effects.remove_if([](Effect& effect) { return effect.update(); });
 }
 
 void EffectLayer::add(const Animation& animation,
@@ -54,7 +51,11 @@ void EffectLayer::add(const Animation& animation,
                       std::int8_t z,
                       float speed)
 {
-    effects[z].emplace_back(animation, args, speed);
+    auto after = std::find_if(effects.begin(),
+                              effects.end(),
+                              [z](const Effect& e) { return e.get_z() > z; });
+    auto index = static_cast<std::size_t>(after - effects.begin());
+    effects.emplace(index, animation, args, z, speed);
 }
 
 void EffectLayer::add(const Animation& animation,
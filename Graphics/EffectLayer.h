@@ -17,10 +17,8 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "../Constants.h"
+#include "../Template/FixedPool.h"
 #include "Sprite.h"
-#include "boost/container/flat_map.hpp"
-
-#include <vector>
 
 namespace jrc
 {
@@ -47,8 +45,15 @@ private:
     class Effect
     {
     public:
-        Effect(const Animation& a, const DrawArgument& args, float s)
-            : sprite(a, args), speed(s)
+        Effect(const Animation& a,
+               const DrawArgument& args,
+               std::int8_t z_index,
+               float s)
+            : sprite(a, args), z(z_index), speed(s)
+        {
+        }
+
+        Effect() noexcept : z(0), speed(1.0f)
         {
         }
 
@@ -63,13 +68,23 @@ private:
                 static_cast<std::uint16_t>(Constants::TIMESTEP * speed));
         }
 
+        std::int8_t get_z() const
+        {
+            return z;
+        }
+
     private:
         Sprite sprite;
+        std::int8_t z;
         float speed;
     };
 
-    //! Sorted map that associates z-indices (can be negative or non-negative)
-    //! with the effects at that z-index.
-    boost::container::flat_map<std::int8_t, std::vector<Effect>> effects;
+    //! The most effects shown at once, after which those with the lowest
+    //! z-index make room.
+    static constexpr std::size_t MAX_EFFECTS = 16;
+
+    //! Effects sorted by their z-index (which can be negative or
+    //! non-negative), and in the order they were added for the same index.
+    FixedPool<Effect, MAX_EFFECTS> effects;
 };
 } // namespace jrc
@@ -0,0 +1,444 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "GLBackend.h"
+
+#include "../Constants.h"
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+
+namespace jrc
+{
+GLBackend::GLBackend() noexcept
+    : atlas{},
+      vbo{0},
+      atlas_texture{0},
+      gradient_texture{0},
+      glyph_page{0},
+      glyph_page_height{0},
+      pbos{},
+      next_pbo{0},
+      use_pbos{false},
+      program{0},
+      attribute_coord{-1},
+      attribute_color{-1},
+      attribute_tile{-1},
+      uniform_texture{-1},
+      uniform_atlas_size{-1},
+      uniform_screen_size{-1},
+      uniform_y_offset{-1},
+      uniform_glyphs{-1},
+      uniform_glyph_size{-1}
+{
+}
+
+Error GLBackend::init(Atlas& new_atlas, bool linear_glyphs)
+{
+    if (glewInit()) {
+        return Error::GLEW;
+    }
+
+    GLint result = GL_FALSE;
+
+    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
+    const char* vs_source = R"(#version 120
+attribute vec4 coord;
+attribute vec4 color;
+attribute vec4 tile;
+
+varying vec2 texpos;
+varying vec4 colormod;
+varying vec4 tilerect;
+
+uniform vec2 screensize;
+uniform int yoffset;
+
+void main(void) {
+    float x = -1.0 + coord.x * 2.0 / screensize.x;
+    float y = 1.0 - (coord.y + yoffset) * 2.0 / screensize.y;
+
+    gl_Position = vec4(x, y, 0.0, 1.0);
+    texpos = coord.zw;
+    colormod = color;
+    tilerect = tile;
+})";
+
+    glShaderSource(vs, 1, &vs_source, NULL);
+    glCompileShader(vs);
+    glGetShaderiv(vs, GL_COMPILE_STATUS, &result);
+    if (!result) {
+        return Error::VERTEX_SHADER;
+    }
+
+    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
+    const char* fs_source = R"(#version 120
+varying vec2 texpos;
+varying vec4 colormod;
+varying vec4 tilerect;
+
+uniform sampler2D texture;
+uniform sampler2D glyphs;
+uniform vec2 atlassize;
+uniform vec2 glyphsize;
+
+void main(void) {
+    if (tilerect.z > 0) {
+        // A repeated sprite. The position is wrapped into the rectangle of
+        // the sprite, so that one quad can cover any number of repetitions.
+        vec2 atlaspos = tilerect.xy + mod(texpos, tilerect.zw);
+        gl_FragColor = texture2D(texture, atlaspos / atlassize) * colormod;
+    } else if (texpos.y == 0) {
+        gl_FragColor = colormod;
+    } else if (texpos.y < 0 && texpos.x < 0) {
+        // A distance field glyph, with columns and rows stored negated and
+        // shifted by one. 0.5 is the outline.
+        vec2 glyphpos = -texpos - vec2(1.0, 1.0);
+        float distance = texture2D(glyphs, glyphpos / glyphsize).r;
+        float smoothing = fwidth(distance) * 0.75;
+        gl_FragColor = vec4(
+            1,
+            1,
+            1,
+            smoothstep(0.5 - smoothing, 0.5 + smoothing, distance)
+        ) * colormod;
+    } else if (texpos.y < 0) {
+        // Glyph rows are stored negated and shifted by one.
+        vec2 glyphpos = vec2(texpos.x, -texpos.y - 1.0);
+        gl_FragColor = vec4(
+            1,
+            1,
+            1,
+            texture2D(glyphs, glyphpos / glyphsize).r
+        ) * colormod;
+    } else {
+        gl_FragColor = texture2D(texture, texpos / atlassize) * colormod;
+    }
+})";
+
+    glShaderSource(fs, 1, &fs_source, NULL);
+    glCompileShader(fs);
+    glGetShaderiv(fs, GL_COMPILE_STATUS, &result);
+    if (!result) {
+        return Error::FRAGMENT_SHADER;
+    }
+
+    program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+    if (!result) {
+        return Error::SHADER_PROGRAM;
+    }
+
+    attribute_coord = glGetAttribLocation(program, "coord");
+    attribute_color = glGetAttribLocation(program, "color");
+    attribute_tile = glGetAttribLocation(program, "tile");
+    uniform_texture = glGetUniformLocation(program, "texture");
+    uniform_atlas_size = glGetUniformLocation(program, "atlassize");
+    uniform_screen_size = glGetUniformLocation(program, "screensize");
+    uniform_y_offset = glGetUniformLocation(program, "yoffset");
+    uniform_glyphs = glGetUniformLocation(program, "glyphs");
+    uniform_glyph_size = glGetUniformLocation(program, "glyphsize");
+    if (attribute_coord == -1 || attribute_color == -1 || attribute_tile == -1
+        || uniform_texture == -1 || uniform_atlas_size == -1
+        || uniform_y_offset == -1 || uniform_screen_size == -1
+        || uniform_glyphs == -1 || uniform_glyph_size == -1) {
+        return Error::SHADER_VARS;
+    }
+
+    if (new_atlas.format == AtlasFormat::BC3
+        && !GLEW_EXT_texture_compression_s3tc) {
+        new_atlas.format = AtlasFormat::RGBA4;
+        new_atlas.gradient_page = true;
+    }
+    atlas = new_atlas;
+
+    glGenBuffers(1, &vbo);
+
+    use_pbos = GLEW_ARB_pixel_buffer_object;
+    if (use_pbos) {
+        glGenBuffers(NUM_PBOS, pbos.data());
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (Page page : {SPRITES, GRADIENTS}) {
+        if (page == GRADIENTS && !atlas.gradient_page) {
+            continue;
+        }
+
+        GLuint& texture
+            = page == GRADIENTS ? gradient_texture : atlas_texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            texture_encoding::get_internal_format(atlas.get_format(page)),
+            atlas.get_width(page),
+            atlas.get_height(page),
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            nullptr);
+    }
+
+    // The glyph page is bound to the second texture unit. It is allocated
+    // with its initial height here, and grows in `upload()`.
+    glActiveTexture(GL_TEXTURE1);
+    glGenTextures(1, &glyph_page);
+    glBindTexture(GL_TEXTURE_2D, glyph_page);
+    // Distance fields are scaled, so they need to be interpolated.
+    GLint glyph_filter = linear_glyphs ? GL_LINEAR : GL_NEAREST;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glyph_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glyph_filter);
+    glyph_page_height = GlyphAtlas::INITIAL_HEIGHT;
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 GL_LUMINANCE,
+                 GlyphAtlas::WIDTH,
+                 glyph_page_height,
+                 0,
+                 GL_LUMINANCE,
+                 GL_UNSIGNED_BYTE,
+                 nullptr);
+    glActiveTexture(GL_TEXTURE0);
+
+    return Error::NONE;
+}
+
+void GLBackend::resize(std::int16_t width, std::int16_t height)
+{
+    glViewport(0, 0, width, height);
+
+    glUseProgram(program);
+
+    glUniform1i(uniform_y_offset, Constants::VIEW_Y_OFFSET);
+    glUniform1i(uniform_texture, 0);
+    glUniform1i(uniform_glyphs, 1);
+    glUniform2f(uniform_glyph_size, GlyphAtlas::WIDTH, glyph_page_height);
+    glUniform2f(uniform_screen_size, width, height);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(
+        attribute_coord, 4, GL_SHORT, GL_FALSE, sizeof(Quad::Vertex), 0);
+    glVertexAttribPointer(attribute_color,
+                          4,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(Quad::Vertex),
+                          (const void*)8);
+    glVertexAttribPointer(attribute_tile,
+                          4,
+                          GL_SHORT,
+                          GL_FALSE,
+                          sizeof(Quad::Vertex),
+                          (const void*)24);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, glyph_page);
+    glActiveTexture(GL_TEXTURE0);
+    use_page(SPRITES);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+GLuint GLBackend::get_texture(Page page) const noexcept
+{
+    return page == GRADIENTS ? gradient_texture : atlas_texture;
+}
+
+void GLBackend::use_page(Page page)
+{
+    glBindTexture(GL_TEXTURE_2D, get_texture(page));
+    glUniform2f(
+        uniform_atlas_size, atlas.get_width(page), atlas.get_height(page));
+}
+
+void GLBackend::upload(const std::vector<Upload>& pending)
+{
+    if (pending.empty()) {
+        return;
+    }
+
+    // The glyph page only grows by doubling, and after growing the whole
+    // page is uploaded again.
+    GLshort needed_height = glyph_page_height;
+    std::size_t total_size = 0;
+    for (const Upload& up : pending) {
+        if (up.page == GLYPHS) {
+            needed_height = std::max<GLshort>(needed_height, up.y + up.h);
+        }
+
+        total_size += up.pixels.size();
+    }
+
+    if (needed_height > glyph_page_height) {
+        while (glyph_page_height < needed_height) {
+            glyph_page_height *= 2;
+        }
+
+        glActiveTexture(GL_TEXTURE1);
+        glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GL_LUMINANCE,
+                     GlyphAtlas::WIDTH,
+                     glyph_page_height,
+                     0,
+                     GL_LUMINANCE,
+                     GL_UNSIGNED_BYTE,
+                     nullptr);
+        glUniform2f(uniform_glyph_size, GlyphAtlas::WIDTH, glyph_page_height);
+    }
+
+    // Copy the pixels into a pixel buffer first, so that the driver can
+    // copy them into the textures while the frame goes on instead of right
+    // away. The buffers are used in turn, and orphaned before writing, so
+    // that writing never waits for a copy still in flight.
+    unsigned char* staging = nullptr;
+    if (use_pbos) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[next_pbo]);
+        next_pbo = (next_pbo + 1) % NUM_PBOS;
+
+        glBufferData(GL_PIXEL_UNPACK_BUFFER,
+                     static_cast<GLsizeiptr>(total_size),
+                     nullptr,
+                     GL_STREAM_DRAW);
+        staging = static_cast<unsigned char*>(
+            glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+
+        if (staging) {
+            std::size_t offset = 0;
+            for (const Upload& up : pending) {
+                std::copy(
+                    up.pixels.begin(), up.pixels.end(), staging + offset);
+                offset += up.pixels.size();
+            }
+
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+
+    // With a pixel buffer bound, the pointer is an offset into it.
+    std::size_t offset = 0;
+    for (const Upload& up : pending) {
+        if (up.page == GLYPHS) {
+            glActiveTexture(GL_TEXTURE1);
+        } else {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, get_texture(up.page));
+        }
+
+        const void* pixels = up.pixels.data();
+        if (staging) {
+            pixels = reinterpret_cast<const void*>(offset);
+        }
+
+        if (up.format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D,
+                                      0,
+                                      up.x,
+                                      up.y,
+                                      up.w,
+                                      up.h,
+                                      up.format,
+                                      static_cast<GLsizei>(up.pixels.size()),
+                                      pixels);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D,
+                            0,
+                            up.x,
+                            up.y,
+                            up.w,
+                            up.h,
+                            up.format,
+                            up.type,
+                            pixels);
+        }
+        offset += up.pixels.size();
+    }
+
+    if (staging) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas_texture);
+}
+
+void GLBackend::draw(const std::vector<Quad>& quads,
+                     const std::vector<SpriteBatcher::DrawCall>& calls)
+{
+    glClearColor(1.0, 1.0, 1.0, 1.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    GLsizei csize = static_cast<GLsizei>(quads.size() * sizeof(Quad));
+    glEnableVertexAttribArray(attribute_coord);
+    glEnableVertexAttribArray(attribute_color);
+    glEnableVertexAttribArray(attribute_tile);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, csize, quads.data(), GL_STREAM_DRAW);
+
+    // Glyphs are always bound to their own texture unit, so only the sprite
+    // pages and the blend mode are switched between calls.
+    Page bound = SPRITES;
+    SpriteBatcher::Blend bound_blend = SpriteBatcher::ALPHA;
+    for (const SpriteBatcher::DrawCall& call : calls) {
+        Page page = call.page == GRADIENTS ? GRADIENTS : SPRITES;
+        if (page != bound) {
+            use_page(page);
+            bound = page;
+        }
+
+        if (call.blend != bound_blend) {
+            if (call.blend == SpriteBatcher::ADDITIVE) {
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            } else {
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            }
+
+            bound_blend = call.blend;
+        }
+
+        glDrawArrays(GL_QUADS,
+                     static_cast<GLint>(call.first * Quad::LENGTH),
+                     static_cast<GLsizei>(call.count * Quad::LENGTH));
+    }
+
+    if (bound != SPRITES) {
+        use_page(SPRITES);
+    }
+
+    if (bound_blend != SpriteBatcher::ALPHA) {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    glDisableVertexAttribArray(attribute_coord);
+    glDisableVertexAttribArray(attribute_color);
+    glDisableVertexAttribArray(attribute_tile);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+} // namespace jrc
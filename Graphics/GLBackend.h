@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "RenderBackend.h"
+
+#include <array>
+
+namespace jrc
+{
+//! Draws with OpenGL, into whatever context is current on the thread
+//! calling it.
+class GLBackend : public RenderBackend
+{
+public:
+    GLBackend() noexcept;
+
+    Error init(Atlas& atlas, bool linear_glyphs) override;
+    void resize(std::int16_t width, std::int16_t height) override;
+    void upload(const std::vector<Upload>& pending) override;
+    void draw(const std::vector<Quad>& quads,
+              const std::vector<SpriteBatcher::DrawCall>& calls) override;
+
+private:
+    Atlas atlas;
+    GLuint vbo;
+    GLuint atlas_texture;
+    //! Only created if the atlas has a page for gradients.
+    GLuint gradient_texture;
+    GLuint glyph_page;
+    //! The height the glyph texture was allocated with.
+    GLshort glyph_page_height;
+
+    //! Pixel buffers which uploads are staged in, used in turn.
+    static constexpr std::size_t NUM_PBOS = 3;
+    std::array<GLuint, NUM_PBOS> pbos;
+    std::size_t next_pbo;
+    bool use_pbos;
+
+    GLint program;
+    GLint attribute_coord;
+    GLint attribute_color;
+    GLint attribute_tile;
+    GLint uniform_texture;
+    GLint uniform_atlas_size;
+    GLint uniform_screen_size;
+    GLint uniform_y_offset;
+    GLint uniform_glyphs;
+    GLint uniform_glyph_size;
+
+    //! The texture of a sprite page.
+    GLuint get_texture(Page page) const noexcept;
+    //! Draw from a sprite page, whose texture is bound to the first
+    //! texture unit.
+    void use_page(Page page);
+};
+} // namespace jrc
@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace jrc
+{
+GlyphAtlas::GlyphAtlas()
+    : pixels(static_cast<std::size_t>(WIDTH) * INITIAL_HEIGHT),
+      border{0, 0},
+      row_height{0},
+      page_height{INITIAL_HEIGHT},
+      grown{false}
+{
+}
+
+bool GlyphAtlas::insert(GLshort w,
+                        GLshort h,
+                        const unsigned char* glyph,
+                        Point<GLshort>& position)
+{
+    if (w > WIDTH) {
+        return false;
+    }
+
+    if (border.x() + w > WIDTH) {
+        border.set_x(0);
+        border.shift_y(row_height);
+        row_height = 0;
+    }
+
+    if (border.y() + h > page_height) {
+        GLshort needed = border.y() + h;
+        if (needed > MAX_HEIGHT) {
+            return false;
+        }
+
+        while (page_height < needed) {
+            page_height *= 2;
+        }
+
+        pixels.resize(static_cast<std::size_t>(WIDTH) * page_height);
+        grown = true;
+    }
+
+    position = border;
+    for (GLshort row = 0; row < h; ++row) {
+        std::copy_n(glyph + row * w,
+                    w,
+                    pixels.begin()
+                        + (border.y() + row) * static_cast<std::size_t>(WIDTH)
+                        + border.x());
+    }
+
+    border.shift_x(w);
+    row_height = std::max(row_height, h);
+
+    return true;
+}
+
+bool GlyphAtlas::take_grown() noexcept
+{
+    return std::exchange(grown, false);
+}
+
+GLshort GlyphAtlas::height() const noexcept
+{
+    return page_height;
+}
+
+GLshort GlyphAtlas::used_height() const noexcept
+{
+    return border.y() + row_height;
+}
+
+const std::vector<unsigned char>& GlyphAtlas::get_pixels() const noexcept
+{
+    return pixels;
+}
+} // namespace jrc
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Point.h"
+#include "GL/glew.h"
+
+#include <vector>
+
+namespace jrc
+{
+//! The texture page holding the glyphs of all fonts, separate from the
+//! sprite atlas.
+//!
+//! Glyphs are packed in rows from the top. When the next glyph does not fit
+//! anymore, the page doubles in height, up to `MAX_HEIGHT`. A copy of the
+//! page is kept in memory so that a grown page can be uploaded as a whole.
+class GlyphAtlas
+{
+public:
+    static constexpr GLshort WIDTH = 1024;
+    static constexpr GLshort INITIAL_HEIGHT = 256;
+    static constexpr GLshort MAX_HEIGHT = 4096;
+
+    GlyphAtlas();
+
+    //! Copy a `w` by `h` glyph with one byte per pixel into the page, and
+    //! store its position in `position`. Returns `false` if the page is
+    //! full.
+    bool insert(GLshort w,
+                GLshort h,
+                const unsigned char* glyph,
+                Point<GLshort>& position);
+
+    //! Whether the page grew since the last call.
+    bool take_grown() noexcept;
+
+    GLshort height() const noexcept;
+    //! The number of rows taken by glyphs, including the current row.
+    GLshort used_height() const noexcept;
+    const std::vector<unsigned char>& get_pixels() const noexcept;
+
+private:
+    std::vector<unsigned char> pixels;
+    Point<GLshort> border;
+    GLshort row_height;
+    GLshort page_height;
+    bool grown;
+};
+} // namespace jrc
@@ -0,0 +1,394 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "GlyphRasterizer.h"
+
+#include "../Console.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace jrc
+{
+namespace
+{
+//! Offset to the closest seed pixel, for the distance transform.
+struct Seed {
+    std::int32_t dx;
+    std::int32_t dy;
+
+    std::int32_t distance() const noexcept
+    {
+        return dx * dx + dy * dy;
+    }
+};
+
+constexpr Seed NO_SEED = {1 << 12, 1 << 12};
+
+//! The 2,350 precomposed Hangul syllables of KS X 1001, which cover nearly
+//! all Korean text, as one bit per syllable from U+AC00.
+constexpr std::uint32_t KS_X_1001_SYLLABLES[] = {
+0x3eff0793, 0x1303b011, 0x11102801, 0x05930000, 0xb0111e7b, 0x3b019703,
+    0x00a01112, 0x306b9593, 0x1102b051, 0x11303201, 0x011102b0, 0xb879300a,
+    0x30011306, 0x00800010, 0x100b0113, 0x93000011, 0x00102b03, 0x05930000,
+    0xb051746b, 0x3b011323, 0x00001030, 0x70000000, 0x1303b011, 0x11102900,
+    0x00012180, 0xb0153000, 0x3001030e, 0x02000030, 0x10230111, 0x13000000,
+    0x10106b81, 0x01130300, 0x30111013, 0x00000100, 0x22b85530, 0x30000000,
+    0x9702b011, 0x113afb07, 0x011303b0, 0x00000021, 0x3b0d1b00, 0x03b01138,
+    0x11330113, 0x13000001, 0x111c2b05, 0x00000100, 0xb0111000, 0x2a011300,
+    0x02b01930, 0x10100001, 0x11000000, 0x10300301, 0x07130230, 0x0011146b,
+    0x2b051300, 0x8fb8f974, 0x103b0113, 0x00000000, 0xd9700000, 0x01134ab0,
+    0x0011103b, 0x00001103, 0x2ab15930, 0x10000111, 0x11010000, 0x00100b01,
+    0x01130000, 0x0000102b, 0x20000101, 0x02a01110, 0x30210111, 0x0102b059,
+    0x19300000, 0x011307b0, 0xb011383b, 0x00000003, 0x00000000, 0x383b0d13,
+    0x0103b011, 0x00001000, 0x01130000, 0x00101020, 0x00000100, 0x00000110,
+    0x30000000, 0x00021811, 0x00100000, 0x01110000, 0x00000023, 0x0b019300,
+    0x00301110, 0x302b0111, 0x13c7b011, 0x01303b01, 0x00000280, 0xb0113000,
+    0x2b011383, 0x03b01130, 0x300a0011, 0x1102b011, 0x00002000, 0x01110100,
+    0xa011102b, 0x2b011302, 0x01000010, 0x30000001, 0x13029011, 0x11302b01,
+    0x000066b0, 0xb0113000, 0x6b07d302, 0x07b0113a, 0x00200103, 0x13000000,
+    0x11386b05, 0x011303b0, 0x000010b8, 0x2b051b00, 0x03000110, 0x10000000,
+    0x1102a011, 0x79700a01, 0x0111a2b0, 0x0000100a, 0x00011100, 0x00901110,
+    0x00090111, 0x93000000, 0xf9f2bb05, 0x011322b0, 0x2001323b, 0x00000000,
+    0x06b05930, 0x303b0193, 0x1123a011, 0x11700000, 0x001102b0, 0x00001010,
+    0x03011301, 0x00000110, 0x162b0793, 0x01010010, 0x11300000, 0x01110200,
+    0xb0113029, 0x00000000, 0x0eb05130, 0x383b0513, 0x0303b011, 0x00000100,
+    0x01930000, 0x00001039, 0x3b000302, 0x00000000, 0x00230113, 0x00000000,
+    0x00100000, 0x00010000, 0x90113020, 0x00000002, 0x00000000, 0x10000000,
+    0x11020000, 0x00000301, 0x01130000, 0xb079b02b, 0x3b011323, 0x02b01130,
+    0xf0210111, 0x1343b0d9, 0x11303b01, 0x011103b0, 0xb0517020, 0x20011322,
+    0x01901110, 0x300b0111, 0x9302b011, 0x0016ab01, 0x01130100, 0xb0113021,
+    0x29010302, 0x02b03130, 0x30000000, 0x1b42b819, 0x11383301, 0x00000330,
+    0x00000020, 0x33051300, 0x00001110, 0x00000000, 0x93000001, 0x01302305,
+    0x00010100, 0x30111010, 0x00000100, 0x02301130, 0x10100001, 0x11000000,
+    0x00000000, 0x85130200, 0x10111003, 0x2b011300, 0x63b87730, 0x303b0113,
+    0x11a2b091, 0x7b300201, 0x011357f0, 0xf0d1702b, 0x1b0111e3, 0x0ab97130,
+    0x303b0113, 0x13029001, 0x11302b01, 0x071302b0, 0x3011302b, 0x23011303,
+    0x02b01130, 0x30ab0113, 0x11feb411, 0x71300901, 0x05d347b8, 0xb011307b,
+    0x21015303, 0x00001110, 0x306b0513, 0x1102b011, 0x00103301, 0x05130000,
+    0xa01038eb, 0x30000102, 0x02b01110, 0x30200013, 0x0102b071, 0x00101000,
+    0x01130000, 0x1011100b, 0x2b011300, 0x00000000, 0x366b0593, 0x1303b095,
+    0x01103b01, 0x00000200, 0xb0113000, 0x20000103, 0x01000010, 0x30000000,
+    0x030ab011, 0x00101001, 0x01110100, 0x00000003, 0x23011302, 0x03000010,
+    0x10000000, 0x01000000, 0x00100000, 0x00000290, 0x30113000, 0x7b015386,
+    0x03b01130, 0x00210151, 0x13000000, 0x11303b01, 0x001102b0, 0x00011010,
+    0x2b011302, 0x02001110, 0x10000000, 0x0102b011, 0x11300100, 0x000102b0,
+    0x00011010, 0x2b011100, 0x02101110, 0x002b0113, 0x93000000, 0x11302b03,
+    0x011302b0, 0x0000303b, 0x00000002, 0x03b01930, 0x102b0113, 0x0103b011,
+    0x11300000, 0x011302b0, 0x00001021, 0x00010102, 0x00000010, 0x102b0113,
+    0x01020011, 0x11302000, 0x011102b0, 0x30113001, 0x00000002, 0x02b01130,
+    0x303b0313, 0x0103b011, 0x00002000, 0x05130000, 0xb011303b, 0x10001102,
+    0x00000110, 0x142b0113, 0x01000001, 0x01100000, 0x00010280, 0xb0113000,
+    0x10000102, 0x00000010, 0x10230113, 0x93021011, 0x11100b05, 0x01130030,
+    0xb051702b, 0x3b011323, 0x00000030, 0x30000000, 0x1303b011, 0x11102b01,
+    0x01010330, 0xb011300a, 0x20000102, 0x00000000, 0x10000011, 0x9300a011,
+    0x00102b05, 0x00000200, 0x90111000, 0x29011100, 0x00b01110, 0x30000000,
+    0x1302b011, 0x11302b21, 0x000103b0, 0x00000020, 0x2b051300, 0x02b01130,
+    0x103b0113, 0x13002011, 0x11322b21, 0x00130280, 0xa0113028, 0x0a011102,
+    0x02921130, 0x30210111, 0x13020011, 0x11302b01, 0x03d30290, 0x3011122b,
+    0x2b011302, 0x00000000,
+};
+
+//! Find the closest seed for every pixel with two sweeps over the grid
+//! (8SSEDT).
+void propagate(std::vector<Seed>& grid, std::int32_t w, std::int32_t h)
+{
+    auto compare = [&](Seed& seed,
+                       std::int32_t x,
+                       std::int32_t y,
+                       std::int32_t ox,
+                       std::int32_t oy) {
+        if (x + ox < 0 || x + ox >= w || y + oy < 0 || y + oy >= h) {
+            return;
+        }
+
+        Seed other = grid[(y + oy) * w + x + ox];
+        other.dx += ox;
+        other.dy += oy;
+        if (other.distance() < seed.distance()) {
+            seed = other;
+        }
+    };
+
+    for (std::int32_t y = 0; y < h; ++y) {
+        for (std::int32_t x = 0; x < w; ++x) {
+            Seed& seed = grid[y * w + x];
+            compare(seed, x, y, -1, 0);
+            compare(seed, x, y, 0, -1);
+            compare(seed, x, y, -1, -1);
+            compare(seed, x, y, 1, -1);
+        }
+        for (std::int32_t x = w - 1; x >= 0; --x) {
+            compare(grid[y * w + x], x, y, 1, 0);
+        }
+    }
+
+    for (std::int32_t y = h - 1; y >= 0; --y) {
+        for (std::int32_t x = w - 1; x >= 0; --x) {
+            Seed& seed = grid[y * w + x];
+            compare(seed, x, y, 1, 0);
+            compare(seed, x, y, 0, 1);
+            compare(seed, x, y, -1, 1);
+            compare(seed, x, y, 1, 1);
+        }
+        for (std::int32_t x = 0; x < w; ++x) {
+            compare(grid[y * w + x], x, y, -1, 0);
+        }
+    }
+}
+} // namespace
+
+GlyphRasterizer::GlyphRasterizer() noexcept : stopping{false}
+{
+}
+
+GlyphRasterizer::~GlyphRasterizer()
+{
+    stop();
+}
+
+bool GlyphRasterizer::rasterize(FT_Face face, char32_t c, Glyph& glyph)
+{
+    if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+        return false;
+    }
+
+    const auto g = face->glyph;
+
+    glyph.code_point = c;
+    glyph.ax = static_cast<GLshort>(g->advance.x >> 6);
+    glyph.ay = static_cast<GLshort>(g->advance.y >> 6);
+    glyph.l = static_cast<GLshort>(g->bitmap_left);
+    glyph.t = static_cast<GLshort>(g->bitmap_top);
+    glyph.w = static_cast<GLshort>(g->bitmap.width);
+    glyph.h = static_cast<GLshort>(g->bitmap.rows);
+
+    const unsigned char* buffer = g->bitmap.buffer;
+    glyph.pixels.assign(buffer, buffer + glyph.w * glyph.h);
+
+    return true;
+}
+
+void GlyphRasterizer::make_distance_field(Glyph& glyph)
+{
+    if (glyph.w <= 0 || glyph.h <= 0) {
+        return;
+    }
+
+    const std::int32_t w = glyph.w + 2 * SDF_SPREAD;
+    const std::int32_t h = glyph.h + 2 * SDF_SPREAD;
+    const auto size = static_cast<std::size_t>(w * h);
+
+    // `outside` ends up with the offset to the closest pixel inside the
+    // outline, and `inside` with the offset to the closest one outside.
+    std::vector<Seed> outside(size, NO_SEED);
+    std::vector<Seed> inside(size, Seed{0, 0});
+    for (std::int32_t y = 0; y < glyph.h; ++y) {
+        for (std::int32_t x = 0; x < glyph.w; ++x) {
+            if (glyph.pixels[y * glyph.w + x] >= 128) {
+                std::size_t i = (y + SDF_SPREAD) * w + x + SDF_SPREAD;
+                outside[i] = {0, 0};
+                inside[i] = NO_SEED;
+            }
+        }
+    }
+
+    propagate(outside, w, h);
+    propagate(inside, w, h);
+
+    std::vector<unsigned char> field(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        float distance
+            = std::sqrt(static_cast<float>(inside[i].distance()))
+              - std::sqrt(static_cast<float>(outside[i].distance()));
+        float value = 0.5f + distance / (2.0f * SDF_SPREAD);
+        field[i] = static_cast<unsigned char>(
+            std::clamp(value, 0.0f, 1.0f) * 255.0f);
+    }
+
+    glyph.pixels = std::move(field);
+    glyph.w = static_cast<GLshort>(w);
+    glyph.h = static_cast<GLshort>(h);
+    glyph.l -= SDF_SPREAD;
+    glyph.t += SDF_SPREAD;
+}
+
+std::vector<GlyphRasterizer::CodeRange>
+GlyphRasterizer::get_locale_ranges(std::string_view locale)
+{
+    // Latin-1 Supplement and Latin Extended-A.
+    static constexpr CodeRange LATIN = {U'\u00A0', U'\u017F'};
+
+    if (locale.empty() || locale == "en") {
+        return {};
+    } else if (locale == "de" || locale == "es" || locale == "fr"
+               || locale == "it" || locale == "nl" || locale == "pl"
+               || locale == "pt") {
+        return {LATIN};
+    } else if (locale == "ko") {
+        // Hangul Compatibility Jamo, then the common syllables. All 11,172
+        // syllables would not fit into the glyph page for every font.
+        std::vector<CodeRange> ranges = {{U'\u3131', U'\u318E'}};
+        for (char32_t i = 0; i < U'\uD7A4' - U'\uAC00'; ++i) {
+            if (!(KS_X_1001_SYLLABLES[i / 32] & (1u << (i % 32)))) {
+                continue;
+            }
+
+            char32_t c = U'\uAC00' + i;
+            if (ranges.back().second + 1 == c) {
+                ranges.back().second = c;
+            } else {
+                ranges.emplace_back(c, c);
+            }
+        }
+
+        return ranges;
+    } else if (locale == "ja") {
+        // CJK punctuation, hiragana, katakana and full-width forms. Kanji
+        // are left to be rendered when they are first used.
+        return {{U'\u3000', U'\u30FF'}, {U'\uFF01', U'\uFF9F'}};
+    } else if (locale == "zh") {
+        return {{U'\u3000', U'\u303F'}, {U'\uFF01', U'\uFF5E'}};
+    }
+
+    Console::get().print("[Warning] No glyph ranges known for locale \""
+                         + std::string{locale} + "\".");
+
+    return {};
+}
+
+void GlyphRasterizer::start(const std::vector<Source>& sources,
+                            bool distance_fields)
+{
+    if (worker.joinable()) {
+        return;
+    }
+
+    stopping = false;
+    worker = std::thread{
+        &GlyphRasterizer::run, this, sources, distance_fields};
+}
+
+void GlyphRasterizer::enqueue(CodeRange range)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        ranges.push_back(range);
+    }
+
+    queued.notify_one();
+}
+
+void GlyphRasterizer::poll(std::vector<Glyph>& glyphs)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (finished.empty()) {
+        return;
+    }
+
+    glyphs.insert(glyphs.end(),
+                  std::make_move_iterator(finished.begin()),
+                  std::make_move_iterator(finished.end()));
+    finished.clear();
+}
+
+void GlyphRasterizer::stop()
+{
+    if (!worker.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    queued.notify_one();
+    worker.join();
+}
+
+void GlyphRasterizer::run(std::vector<Source> sources, bool distance_fields)
+{
+    FT_Library library;
+    if (FT_Init_FreeType(&library)) {
+        return;
+    }
+
+    std::vector<FT_Face> faces(sources.size(), nullptr);
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const Source& source = sources[i];
+        if (FT_New_Face(library, source.path.c_str(), 0, &faces[i])) {
+            faces[i] = nullptr;
+        } else if (FT_Set_Pixel_Sizes(faces[i], 0, source.height)) {
+            FT_Done_Face(faces[i]);
+            faces[i] = nullptr;
+        }
+    }
+
+    std::vector<Glyph> batch;
+    for (;;) {
+        CodeRange range;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            queued.wait(lock, [this] { return stopping || !ranges.empty(); });
+
+            if (stopping) {
+                break;
+            }
+
+            range = ranges.front();
+            ranges.pop_front();
+        }
+
+        for (char32_t c = range.first; c <= range.second && !stopping; ++c) {
+            for (std::size_t i = 0; i < faces.size(); ++i) {
+                if (!faces[i] || FT_Get_Char_Index(faces[i], c) == 0) {
+                    continue;
+                }
+
+                Glyph glyph;
+                glyph.source = static_cast<std::uint8_t>(i);
+                if (!rasterize(faces[i], c, glyph)) {
+                    continue;
+                }
+
+                if (distance_fields) {
+                    make_distance_field(glyph);
+                }
+
+                batch.push_back(std::move(glyph));
+            }
+
+            if (batch.size() >= BATCH_SIZE || c == range.second) {
+                std::lock_guard<std::mutex> lock{mutex};
+                finished.insert(finished.end(),
+                                std::make_move_iterator(batch.begin()),
+                                std::make_move_iterator(batch.end()));
+                batch.clear();
+            }
+        }
+    }
+
+    for (FT_Face face : faces) {
+        if (face) {
+            FT_Done_Face(face);
+        }
+    }
+
+    FT_Done_FreeType(library);
+}
+} // namespace jrc
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "GL/glew.h"
+#include "Text.h"
+#include "ft2build.h"
+#include FT_FREETYPE_H
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace jrc
+{
+//! Rasterizes ranges of glyphs on a background thread.
+//!
+//! FreeType faces may not be shared between threads, so the worker loads
+//! its own faces from the same files. The glyphs it produces are picked up
+//! with `poll()` and added to the glyph page at the start of a frame.
+//!
+//! Glyphs are either coverage bitmaps for one pixel size, or signed
+//! distance fields rendered at `SDF_SIZE`, which the shader can draw at
+//! any size.
+class GlyphRasterizer
+{
+public:
+    //! An inclusive range of code points.
+    using CodeRange = std::pair<char32_t, char32_t>;
+
+    //! A rendered glyph, with one byte of coverage or distance per pixel.
+    struct Glyph {
+        //! Index of the source the glyph was rendered from.
+        std::uint8_t source;
+        char32_t code_point;
+        GLshort ax;
+        GLshort ay;
+        GLshort l;
+        GLshort t;
+        GLshort w;
+        GLshort h;
+        std::vector<unsigned char> pixels;
+    };
+
+    //! The file and pixel height of a font.
+    struct Source {
+        std::string path;
+        FT_UInt height = 0;
+    };
+
+    //! Pixel height distance field glyphs are rendered at.
+    static constexpr FT_UInt SDF_SIZE = 32;
+    //! Distance in pixels at `SDF_SIZE` covered by a distance field, on each
+    //! side of the outline. Distance field glyphs are padded by as much.
+    static constexpr GLshort SDF_SPREAD = 4;
+
+    GlyphRasterizer() noexcept;
+    ~GlyphRasterizer();
+
+    GlyphRasterizer(const GlyphRasterizer&) = delete;
+    GlyphRasterizer& operator=(const GlyphRasterizer&) = delete;
+
+    //! Render a single glyph with `face` into `glyph`.
+    static bool rasterize(FT_Face face, char32_t c, Glyph& glyph);
+    //! Turn a rendered glyph into a padded signed distance field, where 128
+    //! is the outline and higher values are inside.
+    static void make_distance_field(Glyph& glyph);
+    //! The code points worth rendering ahead of time for a locale, such as
+    //! "ko" or "de". Printable ASCII is always rendered at startup and is not
+    //! included.
+    static std::vector<CodeRange> get_locale_ranges(std::string_view locale);
+
+    //! Start the worker with the fonts to rasterize for, producing distance
+    //! fields if `distance_fields` is set.
+    void start(const std::vector<Source>& sources, bool distance_fields);
+    //! Rasterize `range` for every source.
+    void enqueue(CodeRange range);
+    //! Move the glyphs finished so far to the end of `glyphs`.
+    void poll(std::vector<Glyph>& glyphs);
+    void stop();
+
+private:
+    void run(std::vector<Source> sources, bool distance_fields);
+
+    //! Glyphs are handed over in batches to keep the lock cheap.
+    static constexpr std::size_t BATCH_SIZE = 64;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::deque<CodeRange> ranges;
+    std::vector<Glyph> finished;
+    std::atomic<bool> stopping;
+};
+} // namespace jrc
@@ -20,15 +20,31 @@
 #include "../Configuration.h"
 #include "../Console.h"
 #include "../IO/Window.h"
+#include "../Util/FrameScheduler.h"
+#include "../Util/Profiler.h"
 #include "tinyutf8.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <utility>
 
 namespace jrc
 {
 Rectangle<std::int16_t> GraphicsGL::screen;
 
-GraphicsGL::GraphicsGL() noexcept : locked{false}, font_border{0, 0}
+GraphicsGL::GraphicsGL() noexcept
+    : locked{false},
+      layer{SpriteBatcher::WORLD},
+      blend{SpriteBatcher::ALPHA},
+      draw_calls{0},
+      atlas{ATLAS_SIZE, ATLAS_SIZE, AtlasFormat::RGBA8, false},
+      upload_budget{0},
+      refilling{false},
+      sdf_enabled{false},
+      sdf_faces{},
+      reinit_pending{false},
+      has_next_frame{false},
+      render_stop{false}
 {
     screen = {0,
               Constants::VIEW_WIDTH,
@@ -36,307 +52,509 @@ GraphicsGL::GraphicsGL() noexcept : locked{false}, font_border{0, 0}
               -Constants::VIEW_Y_OFFSET + Constants::VIEW_HEIGHT};
 }
 
-Error GraphicsGL::init()
+Error GraphicsGL::init_fonts()
 {
-    if (glewInit()) {
-        return Error::GLEW;
-    }
-
     if (FT_Init_FreeType(&ft_library)) {
         return Error::FREETYPE;
     }
 
-    GLint result = GL_FALSE;
+    const std::string& FONT_NORMAL = Configuration::get().fonts.normal;
+    const std::string& FONT_BOLD = Configuration::get().fonts.bold;
+    if (FONT_NORMAL.empty() || FONT_BOLD.empty()) {
+        Console::get().print(
+            "[Warning] A font path is empty, check your settings file.");
+    }
 
-    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-    const char* vs_source = R"(#version 120
-attribute vec4 coord;
-attribute vec4 color;
+    const char* const FONT_NORMAL_STR = FONT_NORMAL.data();
+    const char* const FONT_BOLD_STR = FONT_BOLD.data();
 
-varying vec2 texpos;
-varying vec4 colormod;
+    sdf_enabled = Configuration::get().fonts.sdf;
+    if (sdf_enabled) {
+        const char* const paths[NUM_FACES] = {FONT_NORMAL_STR, FONT_BOLD_STR};
+        for (std::size_t i = 0; i < NUM_FACES; ++i) {
+            if (FT_New_Face(ft_library, paths[i], 0, &sdf_faces[i])
+                || FT_Set_Pixel_Sizes(
+                    sdf_faces[i], 0, GlyphRasterizer::SDF_SIZE)) {
+                Console::get().print("[Warning] Could not load the font "
+                                     "faces for distance field text; using "
+                                     "bitmaps instead.");
+                sdf_enabled = false;
+                break;
+            }
 
-uniform vec2 screensize;
-uniform int yoffset;
+            sdf_sources[i] = {paths[i], GlyphRasterizer::SDF_SIZE};
+        }
+    }
 
-void main(void) {
-    float x = -1.0 + coord.x * 2.0 / screensize.x;
-    float y = 1.0 - (coord.y + yoffset) * 2.0 / screensize.y;
+    addfont(FONT_NORMAL_STR, NORMAL, Text::A11L, 0, 11);
+    addfont(FONT_NORMAL_STR, NORMAL, Text::A11M, 0, 11);
+    addfont(FONT_BOLD_STR, BOLD, Text::A11B, 0, 11);
+    addfont(FONT_NORMAL_STR, NORMAL, Text::A12M, 0, 12);
+    addfont(FONT_BOLD_STR, BOLD, Text::A12B, 0, 12);
+    addfont(FONT_NORMAL_STR, NORMAL, Text::A13M, 0, 13);
+    addfont(FONT_BOLD_STR, BOLD, Text::A13B, 0, 13);
+    addfont(FONT_NORMAL_STR, NORMAL, Text::A18M, 0, 18);
 
-    gl_Position = vec4(x, y, 0.0, 1.0);
-    texpos = coord.zw;
-    colormod = color;
-})";
+    return Error::NONE;
+}
 
-    glShaderSource(vs, 1, &vs_source, NULL);
-    glCompileShader(vs);
-    glGetShaderiv(vs, GL_COMPILE_STATUS, &result);
-    if (!result) {
-        return Error::VERTEX_SHADER;
+Error GraphicsGL::init(std::unique_ptr<RenderBackend> new_backend)
+{
+    const Configuration::Video& video = Configuration::get().video;
+    atlas.format = get_atlas_format(video.atlas_format);
+    if (video.low_quality) {
+        atlas.width = LOW_QUALITY_ATLAS_SIZE;
+        atlas.height = LOW_QUALITY_ATLAS_SIZE;
+        if (atlas.format == AtlasFormat::RGBA8) {
+            atlas.format = AtlasFormat::RGBA4;
+        }
     }
+    atlas.gradient_page = atlas.format == AtlasFormat::RGBA4;
 
-    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-    const char* fs_source = R"(#version 120
-varying vec2 texpos;
-varying vec4 colormod;
-
-uniform sampler2D texture;
-uniform vec2 atlassize;
-uniform int fontregion;
+    AtlasFormat requested_format = atlas.format;
+    backend = std::move(new_backend);
+    if (Error error = backend->init(atlas, sdf_enabled)) {
+        return error;
+    }
 
-void main(void) {
-    if (texpos.y == 0) {
-        gl_FragColor = colormod;
-    } else if (texpos.y <= fontregion) {
-        gl_FragColor = vec4(
-            1,
-            1,
-            1,
-            texture2D(texture, texpos / atlassize).r
-        ) * colormod;
-    } else {
-        gl_FragColor = texture2D(texture, texpos / atlassize) * colormod;
-    }
-})";
-
-    glShaderSource(fs, 1, &fs_source, NULL);
-    glCompileShader(fs);
-    glGetShaderiv(fs, GL_COMPILE_STATUS, &result);
-    if (!result) {
-        return Error::FRAGMENT_SHADER;
-    }
-
-    program = glCreateProgram();
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &result);
-    if (!result) {
-        return Error::SHADER_PROGRAM;
-    }
-
-    attribute_coord = glGetAttribLocation(program, "coord");
-    attribute_color = glGetAttribLocation(program, "color");
-    uniform_texture = glGetUniformLocation(program, "texture");
-    uniform_atlas_size = glGetUniformLocation(program, "atlassize");
-    uniform_screen_size = glGetUniformLocation(program, "screensize");
-    uniform_y_offset = glGetUniformLocation(program, "yoffset");
-    uniform_font_region = glGetUniformLocation(program, "fontregion");
-    if (attribute_coord == -1 || attribute_color == -1 || uniform_texture == -1
-        || uniform_atlas_size == -1 || uniform_y_offset == -1
-        || uniform_screen_size == -1) {
-        return Error::SHADER_VARS;
-    }
-
-    glGenBuffers(1, &vbo);
-
-    glGenTextures(1, &atlas);
-    glBindTexture(GL_TEXTURE_2D, atlas);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexImage2D(GL_TEXTURE_2D,
-                 0,
-                 GL_RGBA,
-                 ATLASW,
-                 ATLASH,
-                 0,
-                 GL_RGBA,
-                 GL_UNSIGNED_BYTE,
-                 nullptr);
-
-    font_border.set_y(1);
+    if (atlas.format != requested_format) {
+        Console::get().print("[Warning] Compressed textures are not "
+                             "supported; using 16-bit textures instead.");
+    }
 
-    const std::string& FONT_NORMAL = Configuration::get().fonts.normal;
-    const std::string& FONT_BOLD = Configuration::get().fonts.bold;
-    if (FONT_NORMAL.empty() || FONT_BOLD.empty()) {
-        Console::get().print(
-            "[Warning] A font path is empty, check your settings file.");
+    // Upload the glyphs rasterized by `init_fonts()`.
+    backend->upload(uploads);
+    uploads.clear();
+    uploads.shrink_to_fit();
+
+    sprite_page.width = atlas.get_width(RenderBackend::SPRITES);
+    sprite_page.height = atlas.get_height(RenderBackend::SPRITES);
+    sprite_page.format = atlas.get_format(RenderBackend::SPRITES);
+    sprite_page.clear();
+    if (atlas.gradient_page) {
+        gradient_page.width = atlas.get_width(RenderBackend::GRADIENTS);
+        gradient_page.height = atlas.get_height(RenderBackend::GRADIENTS);
+        gradient_page.format = atlas.get_format(RenderBackend::GRADIENTS);
+        gradient_page.clear();
     }
 
-    const char* const FONT_NORMAL_STR = FONT_NORMAL.data();
-    const char* const FONT_BOLD_STR = FONT_BOLD.data();
+    upload_budget = Configuration::get().performance.upload_budget * 1024;
+    decoder.start(atlas.format, atlas.gradient_page);
 
-    addfont(FONT_NORMAL_STR, Text::A11L, 0, 11);
-    addfont(FONT_NORMAL_STR, Text::A11M, 0, 11);
-    addfont(FONT_BOLD_STR, Text::A11B, 0, 11);
-    addfont(FONT_NORMAL_STR, Text::A12M, 0, 12);
-    addfont(FONT_BOLD_STR, Text::A12B, 0, 12);
-    addfont(FONT_NORMAL_STR, Text::A13M, 0, 13);
-    addfont(FONT_BOLD_STR, Text::A13B, 0, 13);
-    addfont(FONT_NORMAL_STR, Text::A18M, 0, 18);
-
-    font_y_max += font_border.y();
-
-    leftovers = QuadTree<std::size_t, Leftover>{
-        [](const Leftover& first, const Leftover& second) {
-            bool wcomp = first.width() >= second.width();
-            bool hcomp = first.height() >= second.height();
-            if (wcomp && hcomp) {
-                return QuadTree<std::size_t, Leftover>::RIGHT;
-            } else if (wcomp) {
-                return QuadTree<std::size_t, Leftover>::DOWN;
-            } else if (hcomp) {
-                return QuadTree<std::size_t, Leftover>::UP;
-            } else {
-                return QuadTree<std::size_t, Leftover>::LEFT;
-            }
-        }};
+    // Render the glyphs the locale is likely to need in the background.
+    if (sdf_enabled) {
+        rasterizer.start({sdf_sources.begin(), sdf_sources.end()}, true);
+    } else {
+        rasterizer.start({font_sources.begin(), font_sources.end()}, false);
+    }
+    for (auto range : GlyphRasterizer::get_locale_ranges(
+             Configuration::get().fonts.locale)) {
+        rasterizer.enqueue(range);
+    }
 
     return Error::NONE;
 }
 
+QuadTree<std::size_t, GraphicsGL::Leftover>::Direction
+GraphicsGL::compare_leftovers(const Leftover& first, const Leftover& second)
+{
+    bool wcomp = first.width() >= second.width();
+    bool hcomp = first.height() >= second.height();
+    if (wcomp && hcomp) {
+        return QuadTree<std::size_t, Leftover>::RIGHT;
+    } else if (wcomp) {
+        return QuadTree<std::size_t, Leftover>::DOWN;
+    } else if (hcomp) {
+        return QuadTree<std::size_t, Leftover>::UP;
+    } else {
+        return QuadTree<std::size_t, Leftover>::LEFT;
+    }
+}
+
 bool GraphicsGL::addfont(const char* name,
+                         Face face_id,
                          Text::Font id,
                          FT_UInt pixelw,
                          FT_UInt pixelh)
 {
-    FT_Face face;
-    if (FT_New_Face(ft_library, name, 0, &face)) {
-        return false;
+    if (sdf_enabled) {
+        // Glyphs are shared with the other sizes of the face, and only
+        // scaled for this one.
+        fonts[id] = Font{nullptr};
+        fonts[id].sdf_face = face_id;
+        fonts[id].sdf_scale = static_cast<float>(pixelh)
+                              / static_cast<float>(GlyphRasterizer::SDF_SIZE);
+    } else {
+        FT_Face face;
+        if (FT_New_Face(ft_library, name, 0, &face)) {
+            return false;
+        }
+
+        if (FT_Set_Pixel_Sizes(face, pixelw, pixelh)) {
+            return false;
+        }
+
+        fonts[id] = Font{face};
+        font_sources[id] = {name, pixelh};
     }
 
-    if (FT_Set_Pixel_Sizes(face, pixelw, pixelh)) {
-        return false;
+    // Adding a glyph raises the height of the font to that of its tallest
+    // glyph.
+    for (char32_t c = U' '; c <= U'~'; ++c) {
+        insert_glyph(fonts[id], c);
     }
 
-    FT_GlyphSlot g = face->glyph;
+    return true;
+}
 
-    /*
-    GLshort width = 0;
-    GLshort height = 0;
-    for (char32_t c = U' '; c <= U'~'; ++c) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            continue;
-        }
+void GraphicsGL::reinit()
+{
+    if (is_render_thread_running()) {
+        // The render thread owns the context, so it applies the new GL state
+        // together with the next frame. The atlas bookkeeping lives on this
+        // thread and is reset right away.
+        std::lock_guard<std::mutex> lock{frame_mutex};
+        reinit_pending = true;
+    } else {
+        backend->resize(Window::get().get_width(), Window::get().get_height());
+    }
 
-        GLshort w = static_cast<GLshort>(g->bitmap.width);
-        GLshort h = static_cast<GLshort>(g->bitmap.rows);
+    clear_internal();
+}
 
-        width += w;
-        if (h > height) {
-            height = h;
-        }
+void GraphicsGL::clear_internal()
+{
+    // Bitmaps which are still being decoded have no place yet, so they stay
+    // in `loading` and go into the new atlas.
+    offsets.clear();
+    sprite_page.clear();
+    gradient_page.clear();
+
+    // Everything on screen has to be uploaded again, and spreading that
+    // over many frames would leave the map blank for as long.
+    refilling = true;
+}
+
+void GraphicsGL::clear()
+{
+    if (sprite_page.get_usage() > 80.0f
+        || gradient_page.get_usage() > 80.0f) {
+        clear_internal();
     }
-    */
+}
 
-    /*
-    if (font_border.x() + width > ATLASW) {
-        font_border.set_x(0);
-        font_border.set_y(font_y_max);
-        font_y_max = 0;
+void GraphicsGL::SpritePage::clear()
+{
+    // Texture coordinates with a y of 0 mean "no texture" to the shader.
+    // Block compressed bitmaps have to start on a block.
+    border = {0, texture_encoding::align(format, 1)};
+    y_range = {};
+
+    leftovers.clear();
+    rlid = 1;
+    wasted = 0;
+}
+
+float GraphicsGL::SpritePage::get_usage() const noexcept
+{
+    if (width <= 0 || height <= 0) {
+        return 0.0f;
     }
-    */
 
-    // GLshort x = font_border.x();
-    // GLshort y = font_border.y();
+    std::size_t used = width * border.y() + border.x() * y_range.second();
+    return 100.0f * static_cast<float>(used)
+           / static_cast<float>(width * height);
+}
 
-    /*
-    font_border.shift_x(width);
-    if (height > font_y_max) {
-        font_y_max = height;
+void GraphicsGL::add_rasterized_glyphs()
+{
+    rasterizer.poll(rasterized);
+    if (rasterized.empty()) {
+        return;
     }
-    */
 
-    fonts[id] = Font{face};
+    std::size_t count = std::min(rasterized.size(), MAX_GLYPHS_PER_FRAME);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (glyph_atlas.used_height() >= MAX_PREWARM_HEIGHT) {
+            // The remaining glyphs would take the room of those needed
+            // later on.
+            rasterizer.stop();
+            rasterized.clear();
+            return;
+        }
 
-    GLshort font_height = 0;
-    for (char32_t c = U' '; c <= U'~'; ++c) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            continue;
+        const GlyphRasterizer::Glyph& glyph = rasterized[i];
+
+        // The glyph may have been needed and rendered in the meantime.
+        if (sdf_enabled) {
+            auto face = static_cast<Face>(glyph.source);
+            if (sdf_glyphs[face].count(glyph.code_point) == 0) {
+                add_sdf_glyph(face, glyph);
+            }
+        } else {
+            Font& font = fonts[glyph.source];
+            if (!font.find_char(glyph.code_point)) {
+                add_glyph(font, glyph);
+            }
         }
+    }
 
-        GLshort ax = static_cast<GLshort>(g->advance.x >> 6);
-        GLshort ay = static_cast<GLshort>(g->advance.y >> 6);
-        GLshort l = static_cast<GLshort>(g->bitmap_left);
-        GLshort t = static_cast<GLshort>(g->bitmap_top);
-        GLshort w = static_cast<GLshort>(g->bitmap.width);
-        GLshort h = static_cast<GLshort>(g->bitmap.rows);
+    rasterized.erase(rasterized.begin(), rasterized.begin() + count);
+}
 
-        if (font_border.x() + w > ATLASW) {
-            font_border.set_x(0);
-            font_border.shift_y(font_y_max);
+void GraphicsGL::add_decoded_bitmaps()
+{
+    decoder.poll(decoded);
+
+    // At least one bitmap is uploaded every frame, however large.
+    const std::size_t budget = refilling ? 0 : upload_budget;
+    std::size_t used = 0;
+    std::size_t count = 0;
+    for (; count < decoded.size(); ++count) {
+        BitmapDecoder::Bitmap& bitmap = decoded[count];
+        std::size_t size = bitmap.pixels.size();
+        if (budget > 0 && used > 0 && used + size > budget) {
+            break;
         }
 
-        if (h > font_y_max) {
-            font_y_max = h;
+        // A bitmap which could not be decoded is never drawn.
+        if (bitmap.pixels.empty()) {
+            loading.erase(bitmap.id);
+            broken.insert(bitmap.id);
+            continue;
         }
-        if (h > font_height) {
-            font_height = h;
+
+        used += size;
+        if (!place_bitmap(bitmap)) {
+            clear_internal();
+            if (!place_bitmap(bitmap)) {
+                // Larger than the atlas itself.
+                loading.erase(bitmap.id);
+                broken.insert(bitmap.id);
+            }
         }
+    }
+
+    decoded.erase(decoded.begin(), decoded.begin() + count);
+    if (loading.empty()) {
+        refilling = false;
+    }
+}
 
-        glTexSubImage2D(GL_TEXTURE_2D,
-                        0,
-                        font_border.x(),
-                        font_border.y(),
-                        w,
-                        h,
-                        GL_RED,
-                        GL_UNSIGNED_BYTE,
-                        g->bitmap.buffer);
+bool GraphicsGL::place_bitmap(BitmapDecoder::Bitmap& bitmap)
+{
+    RenderBackend::Page page = bitmap.format == atlas.format
+                                   ? RenderBackend::SPRITES
+                                   : RenderBackend::GRADIENTS;
+    SpritePage& target
+        = page == RenderBackend::GRADIENTS ? gradient_page : sprite_page;
+
+    GLshort w = texture_encoding::align(bitmap.format, bitmap.w);
+    GLshort h = texture_encoding::align(bitmap.format, bitmap.h);
+    Point<GLshort> position;
+    if (!target.place(w, h, position)) {
+        if (page == RenderBackend::SPRITES) {
+            return false;
+        }
 
-        Offset offset{font_border.x(), font_border.y(), w, h};
-        fonts[id].add_char(c, ax, ay, w, h, l, t, offset);
+        // Once the page for gradients is full, they are stored like any
+        // other bitmap. Their pixels are still plain BGRA.
+        std::vector<unsigned char> pixels;
+        texture_encoding::encode(
+            atlas.format, bitmap.pixels.data(), bitmap.w, bitmap.h, pixels);
+        bitmap.pixels = std::move(pixels);
+        bitmap.format = atlas.format;
 
-        font_border.shift_x(w);
+        return place_bitmap(bitmap);
     }
 
-    fonts[id].set_height(font_height);
+    offsets[bitmap.id]
+        = {Offset{position.x(), position.y(), bitmap.w, bitmap.h}, page};
+    loading.erase(bitmap.id);
+    uploads.push_back({position.x(),
+                       position.y(),
+                       w,
+                       h,
+                       texture_encoding::get_upload_format(bitmap.format),
+                       std::move(bitmap.pixels),
+                       page,
+                       texture_encoding::get_upload_type(bitmap.format)});
 
     return true;
 }
 
-void GraphicsGL::reinit()
+AtlasFormat GraphicsGL::get_atlas_format(std::string_view name)
 {
-    glUseProgram(program);
-
-    glUniform1i(uniform_y_offset, Constants::VIEW_Y_OFFSET);
-    glUniform1i(uniform_font_region, font_y_max);
-    glUniform2f(uniform_atlas_size, ATLASW, ATLASH);
-    glUniform2f(uniform_screen_size,
-                Window::get().get_width(),
-                Window::get().get_height());
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glVertexAttribPointer(
-        attribute_coord, 4, GL_SHORT, GL_FALSE, sizeof(Quad::Vertex), 0);
-    glVertexAttribPointer(attribute_color,
-                          4,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          sizeof(Quad::Vertex),
-                          (const void*)8);
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glBindTexture(GL_TEXTURE_2D, atlas);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    if (name == "rgba4") {
+        return AtlasFormat::RGBA4;
+    } else if (name == "bc3") {
+        return AtlasFormat::BC3;
+    } else if (name != "rgba8") {
+        Console::get().print("[Warning] Unknown value for "
+                             "\"settings.toml:video.atlas_format\"; using "
+                             "\"rgba8\".");
+    }
 
-    clear_internal();
+    return AtlasFormat::RGBA8;
 }
 
-void GraphicsGL::clear_internal()
+void GraphicsGL::close()
 {
-    border = {0, font_y_max};
-    y_range = {};
+    decoder.stop();
+    rasterizer.stop();
+}
 
-    offsets.clear();
-    leftovers.clear();
-    rlid = 1;
-    wasted = 0;
+nullable_ptr<GraphicsGL::Font::Char> GraphicsGL::insert_glyph(Font& font,
+                                                              char32_t c)
+{
+    if (font.sdf_scale > 0.0f) {
+        return insert_sdf_glyph(font, c);
+    }
+
+    GlyphRasterizer::Glyph glyph;
+    if (!font.face || !GlyphRasterizer::rasterize(font.face, c, glyph)) {
+        return {};
+    }
+
+    return add_glyph(font, glyph);
 }
 
-void GraphicsGL::clear()
+nullable_ptr<GraphicsGL::Font::Char>
+GraphicsGL::add_glyph(Font& font, const GlyphRasterizer::Glyph& glyph)
 {
-    std::size_t used = ATLASW * border.y() + border.x() * y_range.second();
-    auto used_percent
-        = static_cast<float>(used) / static_cast<float>(ATLASW * ATLASH);
-    if (used_percent > 80.0f) {
-        clear_internal();
+    Point<GLshort> position;
+    if (!place_glyph(glyph, position)) {
+        return {};
     }
+
+    if (glyph.h > font.height) {
+        font.set_height(glyph.h);
+    }
+
+    // Glyph rows are negated and shifted by one, which is how the shader
+    // tells them apart from sprites.
+    Offset offset{position.x(),
+                  static_cast<GLshort>(-position.y() - 1),
+                  glyph.w,
+                  static_cast<GLshort>(-glyph.h)};
+
+    return font.add_char(glyph.code_point,
+                         glyph.ax,
+                         glyph.ay,
+                         glyph.w,
+                         glyph.h,
+                         glyph.l,
+                         glyph.t,
+                         offset);
+}
+
+nullable_ptr<GraphicsGL::Font::Char>
+GraphicsGL::insert_sdf_glyph(Font& font, char32_t c)
+{
+    const SdfGlyph* sdf = nullptr;
+
+    auto& face_glyphs = sdf_glyphs[font.sdf_face];
+    if (auto iter = face_glyphs.find(c); iter != face_glyphs.end()) {
+        sdf = &iter->second;
+    } else {
+        GlyphRasterizer::Glyph glyph;
+        if (!GlyphRasterizer::rasterize(
+                sdf_faces[font.sdf_face], c, glyph)) {
+            return {};
+        }
+
+        GlyphRasterizer::make_distance_field(glyph);
+        sdf = add_sdf_glyph(font.sdf_face, glyph);
+    }
+
+    if (!sdf) {
+        return {};
+    }
+
+    const float scale = font.sdf_scale;
+    auto scaled = [scale](GLshort value) {
+        return static_cast<GLshort>(std::lround(value * scale));
+    };
+
+    // The quad covers the padding of the distance field as well, but the
+    // height of the font only counts the glyph itself.
+    GLshort padding = sdf->w > 0 ? 2 * GlyphRasterizer::SDF_SPREAD : 0;
+    GLshort height = scaled(sdf->h - padding);
+    if (height > font.height) {
+        font.set_height(height);
+    }
+
+    return font.add_char(c,
+                         scaled(sdf->ax),
+                         scaled(sdf->ay),
+                         scaled(sdf->w),
+                         scaled(sdf->h),
+                         scaled(sdf->l),
+                         scaled(sdf->t),
+                         sdf->offset);
+}
+
+const GraphicsGL::SdfGlyph*
+GraphicsGL::add_sdf_glyph(Face face, const GlyphRasterizer::Glyph& glyph)
+{
+    Point<GLshort> position;
+    if (!place_glyph(glyph, position)) {
+        return nullptr;
+    }
+
+    // Columns are negated as well, which tells the shader to treat the
+    // glyph as a distance field.
+    Offset offset{static_cast<GLshort>(-position.x() - 1),
+                  static_cast<GLshort>(-position.y() - 1),
+                  static_cast<GLshort>(-glyph.w),
+                  static_cast<GLshort>(-glyph.h)};
+
+    auto [iter, _] = sdf_glyphs[face].try_emplace(
+        glyph.code_point,
+        SdfGlyph{
+            glyph.ax, glyph.ay, glyph.l, glyph.t, glyph.w, glyph.h, offset});
+
+    return &iter->second;
+}
+
+bool GraphicsGL::place_glyph(const GlyphRasterizer::Glyph& glyph,
+                             Point<GLshort>& position)
+{
+    if (glyph.w <= 0 || glyph.h <= 0) {
+        position = {0, 0};
+        return true;
+    }
+
+    if (!glyph_atlas.insert(glyph.w, glyph.h, glyph.pixels.data(), position)) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            Console::get().print("[Warning] The glyph page is full.");
+        }
+
+        return false;
+    }
+
+    if (glyph_atlas.take_grown()) {
+        const std::vector<unsigned char>& page = glyph_atlas.get_pixels();
+        uploads.push_back({0,
+                           0,
+                           GlyphAtlas::WIDTH,
+                           glyph_atlas.height(),
+                           GL_LUMINANCE,
+                           page,
+                           RenderBackend::GLYPHS});
+    } else {
+        uploads.push_back({position.x(),
+                           position.y(),
+                           glyph.w,
+                           glyph.h,
+                           GL_LUMINANCE,
+                           glyph.pixels,
+                           RenderBackend::GLYPHS});
+    }
+
+    return true;
 }
 
 void GraphicsGL::add_bitmap(const nl::bitmap& bmp)
@@ -344,7 +562,8 @@ void GraphicsGL::add_bitmap(const nl::bitmap& bmp)
     get_offset(bmp);
 }
 
-const GraphicsGL::Offset& GraphicsGL::get_offset(const nl::bitmap& bmp)
+nullable_ptr<const GraphicsGL::Placement>
+GraphicsGL::get_offset(const nl::bitmap& bmp)
 {
     std::size_t id = bmp.id();
     auto offiter = offsets.find(id);
@@ -352,20 +571,30 @@ const GraphicsGL::Offset& GraphicsGL::get_offset(const nl::bitmap& bmp)
         return offiter->second;
     }
 
-    GLshort x = 0;
-    GLshort y = 0;
-    GLshort w = bmp.width();
-    GLshort h = bmp.height();
+    if (bmp.width() == 0 || bmp.height() == 0) {
+        return null_placement;
+    }
 
-    if (w <= 0 || h <= 0) {
-        return null_offset;
+    if (!broken.empty() && broken.count(id) > 0) {
+        return {};
     }
 
-    const auto bmp_data = bmp.data();
-    if (!bmp_data) {
-        return null_offset;
+    // The bitmap is decoded in the background, which also decides the page
+    // it goes to. It is placed and drawn once it is uploaded.
+    if (loading.insert(id).second) {
+        decoder.enqueue(bmp);
     }
 
+    return {};
+}
+
+bool GraphicsGL::SpritePage::place(GLshort w,
+                                   GLshort h,
+                                   Point<GLshort>& position)
+{
+    GLshort x = 0;
+    GLshort y = 0;
+
     auto value = Leftover(x, y, w, h);
     std::size_t lid = leftovers.find_node(value, [
     ](const Leftover& val, const Leftover& leaf) noexcept {
@@ -406,14 +635,21 @@ const GraphicsGL::Offset& GraphicsGL::get_offset(const nl::bitmap& bmp)
             ++rlid;
         }
     } else {
-        if (border.x() + w > ATLASW) {
+        // The page is left as it is when the bitmap does not fit.
+        if (w > width) {
+            return false;
+        }
+
+        bool new_row = border.x() + w > width;
+        GLshort top = new_row ? border.y() + y_range.second() : border.y();
+        if (top + h > height) {
+            return false;
+        }
+
+        if (new_row) {
             border.set_x(0);
             border.shift_y(y_range.second());
-            if (border.y() + h > ATLASH) {
-                clear_internal();
-            } else {
-                y_range = Range<GLshort>();
-            }
+            y_range = Range<GLshort>();
         }
         x = border.x();
         y = border.y();
@@ -443,21 +679,16 @@ const GraphicsGL::Offset& GraphicsGL::get_offset(const nl::bitmap& bmp)
     }
 
     /*
-    std::size_t used = ATLASW * border.y() + border.x() * y_range.second();
-    double usedpercent = static_cast<double>(used) / (ATLASW * ATLASH);
+    std::size_t used = width * border.y() + border.x() * y_range.second();
+    double usedpercent = static_cast<double>(used) / (width * height);
     double wastedpercent = static_cast<double>(wasted) / used;
     Console::get().print("Used: " + std::to_string(usedpercent) + ", wasted: "
     + std::to_string(wastedpercent));
     */
 
-    glTexSubImage2D(
-        GL_TEXTURE_2D, 0, x, y, w, h, GL_BGRA, GL_UNSIGNED_BYTE, bmp_data);
+    position = {x, y};
 
-    return offsets
-        .emplace(std::piecewise_construct,
-                 std::forward_as_tuple(id),
-                 std::forward_as_tuple(x, y, w, h))
-        .first->second;
+    return true;
 }
 
 void GraphicsGL::draw(const nl::bitmap& bmp,
@@ -477,8 +708,109 @@ void GraphicsGL::draw(const nl::bitmap& bmp,
         return;
     }
 
-    quads.emplace_back(
-        rect.l(), rect.r(), rect.t(), rect.b(), get_offset(bmp), color, angle);
+    // Skip the bitmap for as long as its pixels are not in the atlas.
+    auto placement = get_offset(bmp);
+    if (!placement) {
+        return;
+    }
+
+    add_sprite_quad(placement->page,
+                    rect.l(),
+                    rect.r(),
+                    rect.t(),
+                    rect.b(),
+                    placement->offset,
+                    color,
+                    angle);
+}
+
+void GraphicsGL::draw_tiled(const nl::bitmap& bmp,
+                            const Rectangle<std::int16_t>& rect,
+                            Point<std::int16_t> spacing,
+                            Point<std::int16_t> count,
+                            const Color& color)
+{
+    if (locked) {
+        return;
+    }
+
+    if (color.invisible()) {
+        return;
+    }
+
+    std::int16_t width = rect.width();
+    std::int16_t height = rect.height();
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    bool flip_x = rect.l() > rect.r();
+    bool flip_y = rect.t() > rect.b();
+    std::int16_t left = flip_x ? rect.r() : rect.l();
+    std::int16_t top = flip_y ? rect.b() : rect.t();
+
+    Rectangle<std::int16_t> area{
+        left,
+        static_cast<std::int16_t>(left + spacing.x() * (count.x() - 1)
+                                  + width),
+        top,
+        static_cast<std::int16_t>(top + spacing.y() * (count.y() - 1)
+                                  + height)};
+    if (!area.overlaps(screen)) {
+        return;
+    }
+
+    // The shader can only repeat copies which are neither scaled nor
+    // spaced apart. Anything else is drawn one copy at a time.
+    bool repeatable = width == bmp.width() && height == bmp.height()
+                      && (count.x() == 1 || spacing.x() == width)
+                      && (count.y() == 1 || spacing.y() == height);
+    if (!repeatable) {
+        for (std::int16_t i = 0; i < count.x(); ++i) {
+            for (std::int16_t j = 0; j < count.y(); ++j) {
+                Point<std::int16_t> shift{
+                    static_cast<std::int16_t>(spacing.x() * i),
+                    static_cast<std::int16_t>(spacing.y() * j)};
+                draw(bmp,
+                     {rect.get_lt() + shift, rect.get_rb() + shift},
+                     color,
+                     0.0f);
+            }
+        }
+
+        return;
+    }
+
+    auto placement = get_offset(bmp);
+    if (!placement) {
+        return;
+    }
+
+    // Only the visible part is drawn, with texture coordinates counting
+    // from the corner of the copy it starts in. Flipped copies count
+    // backwards from the other corner.
+    std::int16_t l = std::max(area.l(), screen.l());
+    std::int16_t r = std::min(area.r(), screen.r());
+    std::int16_t t = std::max(area.t(), screen.t());
+    std::int16_t b = std::min(area.b(), screen.b());
+
+    auto s = static_cast<GLshort>((l - left) % width);
+    auto u = static_cast<GLshort>((t - top) % height);
+    auto w = static_cast<GLshort>(r - l);
+    auto h = static_cast<GLshort>(b - t);
+    if (flip_x) {
+        s = width - s;
+        w = -w;
+    }
+
+    if (flip_y) {
+        u = height - u;
+        h = -h;
+    }
+
+    add_sprite_quad(
+        placement->page, l, r, t, b, Offset{s, u, w, h}, color, 0.0f);
+    quads.back().repeat(placement->offset);
 }
 
 Text::Layout GraphicsGL::create_layout(const utf8_string& text,
@@ -716,22 +1048,21 @@ void GraphicsGL::draw_text(const DrawArgument& args,
             GLshort bottom = top + h - 2;
             Color ntcolor{0.0f, 0.0f, 0.0f, 0.6f};
 
-            quads.emplace_back(
-                left, right, top, bottom, null_offset, ntcolor, 0.0f);
-            quads.emplace_back(left - 1,
-                               left,
-                               top + 1,
-                               bottom - 1,
-                               null_offset,
-                               ntcolor,
-                               0.0f);
-            quads.emplace_back(right,
-                               right + 1,
-                               top + 1,
-                               bottom - 1,
-                               null_offset,
-                               ntcolor,
-                               0.0f);
+            add_quad(left, right, top, bottom, null_offset, ntcolor, 0.0f);
+            add_quad(left - 1,
+                     left,
+                     top + 1,
+                     bottom - 1,
+                     null_offset,
+                     ntcolor,
+                     0.0f);
+            add_quad(right,
+                     right + 1,
+                     top + 1,
+                     bottom - 1,
+                     null_offset,
+                     ntcolor,
+                     0.0f);
         }
         break;
     default:
@@ -790,7 +1121,7 @@ void GraphicsGL::draw_text(const DrawArgument& args,
                     continue;
                 }
 
-                quads.emplace_back(
+                add_quad(
                     chx, chx + chw, chy, chy + chh, ch.offset, abscolor, 0.0f);
             }
         }
@@ -810,8 +1141,7 @@ void GraphicsGL::draw_rectangle(std::int16_t x,
         return;
     }
 
-    quads.emplace_back(
-        x, x + w, y, y + h, null_offset, Color{r, g, b, a}, 0.0f);
+    add_quad(x, x + w, y, y + h, null_offset, Color{r, g, b, a}, 0.0f);
 }
 
 void GraphicsGL::draw_screen_fill(float r, float g, float b, float a)
@@ -838,47 +1168,233 @@ void GraphicsGL::unlock()
 
 void GraphicsGL::flush(float opacity)
 {
+    JOURNEY_ZONE("GraphicsGL::flush");
+
+    if (is_render_thread_running()) {
+        {
+            std::lock_guard<std::mutex> lock{frame_mutex};
+
+            // The quads are copied because the scene may be locked and
+            // drawn again next frame. Uploads are handed over, and appended
+            // in case the render thread has not consumed the last frame.
+            next_frame.quads = quads;
+            next_frame.keys = keys;
+            next_frame.uploads.insert(
+                next_frame.uploads.end(),
+                std::make_move_iterator(uploads.begin()),
+                std::make_move_iterator(uploads.end()));
+            next_frame.opacity = opacity;
+            next_frame.reinit = next_frame.reinit || reinit_pending;
+            next_frame.width = Window::get().get_width();
+            next_frame.height = Window::get().get_height();
+            reinit_pending = false;
+            has_next_frame = true;
+        }
+
+        uploads.clear();
+        frame_ready.notify_one();
+
+        return;
+    }
+
+    backend->upload(uploads);
+    uploads.clear();
+
+    draw_quads(quads, keys, opacity);
+}
+
+void GraphicsGL::draw_quads(const std::vector<Quad>& frame_quads,
+                            const std::vector<std::uint64_t>& frame_keys,
+                            float opacity)
+{
+    bool reordered = batcher.sort(frame_keys);
     bool cover_scene = opacity != 1.0f;
+
+    // The quads only need to be copied if they are drawn in another order
+    // or the scene is covered.
+    const std::vector<Quad>* drawn = &frame_quads;
+    if (reordered || cover_scene) {
+        sorted_quads.clear();
+        sorted_quads.reserve(frame_quads.size() + 1);
+
+        for (std::uint32_t index : batcher.get_order()) {
+            sorted_quads.push_back(frame_quads[index]);
+        }
+
+        if (cover_scene) {
+            float complement = 1.0f - opacity;
+            Color color{0.0f, 0.0f, 0.0f, complement};
+
+            sorted_quads.emplace_back(screen.l(),
+                                      screen.r(),
+                                      screen.t(),
+                                      screen.b(),
+                                      null_offset,
+                                      color,
+                                      0.0f);
+        }
+
+        drawn = &sorted_quads;
+    }
+
+    // The cover is drawn last, with a call of its own.
+    frame_calls = batcher.get_draw_calls();
     if (cover_scene) {
-        float complement = 1.0f - opacity;
-        Color color{0.0f, 0.0f, 0.0f, complement};
+        frame_calls.push_back({static_cast<std::uint32_t>(frame_quads.size()),
+                               1,
+                               RenderBackend::SPRITES,
+                               SpriteBatcher::ALPHA});
+    }
 
-        quads.emplace_back(screen.l(),
-                           screen.r(),
-                           screen.t(),
-                           screen.b(),
-                           null_offset,
-                           color,
-                           0.0f);
+    backend->draw(*drawn, frame_calls);
+    draw_calls = static_cast<std::uint32_t>(frame_calls.size());
+}
+
+void GraphicsGL::start_render_thread(GLFWwindow* window)
+{
+    if (is_render_thread_running()) {
+        return;
     }
 
-    glClearColor(1.0, 1.0, 1.0, 1.0);
-    glClear(GL_COLOR_BUFFER_BIT);
+    // A context can only be current on one thread at a time.
+    glfwMakeContextCurrent(nullptr);
 
-    GLsizei csize = static_cast<GLsizei>(quads.size() * sizeof(Quad));
-    GLsizei fsize = static_cast<GLsizei>(quads.size() * Quad::LENGTH);
-    glEnableVertexAttribArray(attribute_coord);
-    glEnableVertexAttribArray(attribute_color);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, csize, quads.data(), GL_STREAM_DRAW);
-    glDrawArrays(GL_QUADS, 0, fsize);
+    render_window = window;
+    render_stop = false;
+    has_next_frame = false;
+    render_thread = std::thread{&GraphicsGL::render_loop, this, window};
+}
 
-    glDisableVertexAttribArray(attribute_coord);
-    glDisableVertexAttribArray(attribute_color);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+void GraphicsGL::stop_render_thread()
+{
+    if (!is_render_thread_running()) {
+        return;
+    }
 
-    if (cover_scene) {
-        quads.pop_back();
+    {
+        std::lock_guard<std::mutex> lock{frame_mutex};
+        render_stop = true;
+    }
+
+    frame_ready.notify_one();
+    render_thread.join();
+
+    // Take the context back, including whatever the render thread did not
+    // get to upload.
+    glfwMakeContextCurrent(render_window);
+    render_window = nullptr;
+
+    if (next_frame.reinit || reinit_pending) {
+        backend->resize(Window::get().get_width(), Window::get().get_height());
+    }
+
+    backend->upload(next_frame.uploads);
+    next_frame = {};
+    reinit_pending = false;
+}
+
+bool GraphicsGL::is_render_thread_running() const noexcept
+{
+    return render_thread.joinable();
+}
+
+void GraphicsGL::render_loop(GLFWwindow* window)
+{
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(Configuration::get().video.vsync ? 1 : 0);
+
+    Frame frame;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock{frame_mutex};
+            frame_ready.wait(lock,
+                             [this] { return has_next_frame || render_stop; });
+
+            if (render_stop) {
+                break;
+            }
+
+            // Keep the quad storage of the old frame so that copying the
+            // next one into it does not allocate.
+            std::swap(frame, next_frame);
+            next_frame.uploads.clear();
+            next_frame.reinit = false;
+            has_next_frame = false;
+        }
+
+        JOURNEY_ZONE("GraphicsGL::render");
+
+        if (frame.reinit) {
+            backend->resize(frame.width, frame.height);
+        }
+
+        backend->upload(frame.uploads);
+        draw_quads(frame.quads, frame.keys, frame.opacity);
+
+        glfwSwapBuffers(window);
+        FrameScheduler::get().on_present();
     }
+
+    glfwMakeContextCurrent(nullptr);
 }
 
 void GraphicsGL::clearscene()
 {
     if (!locked) {
         quads.clear();
+        keys.clear();
+        layer = SpriteBatcher::WORLD;
+        blend = SpriteBatcher::ALPHA;
+        depths.clear();
     }
 }
 
+template<typename... Args>
+void GraphicsGL::add_quad(Args&&... args)
+{
+    add_sprite_quad(RenderBackend::SPRITES, std::forward<Args>(args)...);
+}
+
+template<typename... Args>
+void GraphicsGL::add_sprite_quad(RenderBackend::Page page, Args&&... args)
+{
+    const Quad& quad = quads.emplace_back(std::forward<Args>(args)...);
+
+    SpriteBatcher::Bounds bounds{quad.vertices[0].x,
+                                 quad.vertices[0].x,
+                                 quad.vertices[0].y,
+                                 quad.vertices[0].y};
+    for (const Quad::Vertex& vertex : quad.vertices) {
+        bounds.l = std::min(bounds.l, vertex.x);
+        bounds.r = std::max(bounds.r, vertex.x);
+        bounds.t = std::min(bounds.t, vertex.y);
+        bounds.b = std::max(bounds.b, vertex.y);
+    }
+
+    std::uint32_t depth = depths.next(page, blend, bounds);
+    keys.push_back(SpriteBatcher::make_key(layer, depth, page, blend));
+}
+
+void GraphicsGL::set_layer(SpriteBatcher::Layer new_layer) noexcept
+{
+    layer = new_layer;
+}
+
+void GraphicsGL::set_blend(SpriteBatcher::Blend new_blend) noexcept
+{
+    blend = new_blend;
+}
+
+std::uint32_t GraphicsGL::get_draw_calls() const noexcept
+{
+    return draw_calls;
+}
+
+RenderBackend& GraphicsGL::get_backend() noexcept
+{
+    return *backend;
+}
+
 void GraphicsGL::set_screen(Rectangle<std::int16_t>&& new_screen) noexcept
 {
     screen = new_screen;
@@ -22,32 +22,61 @@
 #include "../Template/Singleton.h"
 #include "../Template/nullable_ptr.h"
 #include "../Util/QuadTree.h"
+#include "BitmapDecoder.h"
 #include "DrawArgument.h"
 #include "GL/glew.h"
+#include "GlyphAtlas.h"
+#include "GlyphRasterizer.h"
+#include "RenderBackend.h"
+#include "SpriteBatcher.h"
 #include "Text.h"
 #include "ft2build.h"
 #include "nlnx/bitmap.hpp"
 #include FT_FREETYPE_H
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+struct GLFWwindow;
+
 namespace jrc
 {
-//! Graphics engine which uses OpenGL.
+//! Graphics engine which records frames for a `RenderBackend` to draw,
+//! usually with OpenGL.
 class GraphicsGL : public Singleton<GraphicsGL>
 {
 public:
     GraphicsGL() noexcept;
 
-    //! Initialise all resources.
-    Error init();
+    //! Load the font faces and rasterize their printable ASCII glyphs.
+    //!
+    //! This does not touch the GL context, so it may run on another thread
+    //! before `init()`, which uploads the glyphs.
+    Error init_fonts();
+    //! Initialise all resources, drawing with `backend` from now on.
+    Error init(std::unique_ptr<RenderBackend> backend);
     //! Re-initialise after changing screen modes.
     void reinit();
 
     //! Clear all bitmaps if most of the space is used up.
     void clear();
+    //! Add some of the glyphs rendered in the background to the glyph page.
+    //! Called at the start of every frame.
+    void add_rasterized_glyphs();
+    //! Queue the uploads of bitmaps decoded in the background, up to the
+    //! upload budget unless the atlas is being refilled after a clear.
+    //! Called at the start of every frame.
+    void add_decoded_bitmaps();
+    //! Stop the background threads, which use other singletons.
+    void close();
 
     //! Add a bitmap to the available resources.
     void add_bitmap(const nl::bitmap& bmp);
@@ -56,6 +85,14 @@ public:
               const Rectangle<std::int16_t>& rect,
               const Color& color,
               float angle);
+    //! Draw the bitmap `count` times in each direction, with the first
+    //! copy at `rect` and each next one `spacing` pixels further. Copies
+    //! which touch are drawn as a single quad.
+    void draw_tiled(const nl::bitmap& bmp,
+                    const Rectangle<std::int16_t>& rect,
+                    Point<std::int16_t> spacing,
+                    Point<std::int16_t> count,
+                    const Color& color);
 
     //! Create a layout for the text with the parameters specified.
     Text::Layout create_layout(const utf8_string& text,
@@ -88,7 +125,8 @@ public:
     //! Unlock the scene.
     void unlock();
 
-    //! Draw the buffer contents with the specified scene opacity.
+    //! Draw the buffer contents with the specified scene opacity. When the
+    //! render thread is running, the contents are handed over to it instead.
     void flush(float opacity);
     //! Clear the buffer contents.
     void clearscene();
@@ -100,29 +138,55 @@ public:
                            std::int16_t t,
                            std::int16_t b) noexcept;
 
+    //! Move the GL context of the window to a render thread, which uploads,
+    //! draws and swaps the buffers of each flushed frame. The context must be
+    //! current on the calling thread.
+    void start_render_thread(GLFWwindow* window);
+    //! Stop the render thread and make the context current on the calling
+    //! thread again. Uploads of a frame that was not drawn are kept.
+    void stop_render_thread();
+    //! Whether frames are drawn on the render thread.
+    bool is_render_thread_running() const noexcept;
+
+    //! Draw the quads added from now on in this layer. Reset to the world
+    //! layer with every new scene.
+    void set_layer(SpriteBatcher::Layer layer) noexcept;
+    //! Blend the quads added from now on with this mode. Reset to alpha
+    //! blending with every new scene.
+    void set_blend(SpriteBatcher::Blend blend) noexcept;
+    //! Number of draw calls of the last frame drawn.
+    std::uint32_t get_draw_calls() const noexcept;
+
+    RenderBackend& get_backend() noexcept;
+
 private:
     void clear_internal();
-    bool
-    addfont(const char* name, Text::Font id, FT_UInt width, FT_UInt height);
-
-    struct Offset {
-        GLshort l;
-        GLshort r;
-        GLshort t;
-        GLshort b;
-
-        Offset(GLshort x, GLshort y, GLshort w, GLshort h) noexcept
-            : l{x}, r{x + w}, t{y}, b{y + h}
-        {
-        }
-
-        Offset() noexcept : l{0}, r{0}, t{0}, b{0}
-        {
-        }
+    //! The faces fonts are loaded from.
+    enum Face : std::uint8_t { NORMAL, BOLD, NUM_FACES };
+
+    bool addfont(const char* name,
+                 Face face,
+                 Text::Font id,
+                 FT_UInt width,
+                 FT_UInt height);
+
+    using Offset = RenderBackend::Offset;
+    using Quad = RenderBackend::Quad;
+    using Upload = RenderBackend::Upload;
+
+    //! Where a bitmap is in the sprite textures.
+    struct Placement {
+        Offset offset;
+        RenderBackend::Page page = RenderBackend::SPRITES;
     };
 
-    //! Add a bitmap to the available resources.
-    const Offset& get_offset(const nl::bitmap& bmp);
+    //! Add a bitmap to the available resources. Returns nothing while the
+    //! bitmap is not in the atlas yet.
+    nullable_ptr<const Placement> get_offset(const nl::bitmap& bmp);
+    //! Place a decoded bitmap in its page, and queue its upload. Returns
+    //! false if there was no space left.
+    bool place_bitmap(BitmapDecoder::Bitmap& bitmap);
+    static AtlasFormat get_atlas_format(std::string_view name);
 
     struct Leftover {
         GLshort l;
@@ -150,50 +214,54 @@ private:
         }
     };
 
-    struct Quad {
-        struct Vertex {
-            GLshort x;
-            GLshort y;
-            GLshort s;
-            GLshort t;
-
-            Color c;
-        };
-
-        static const std::size_t LENGTH = 4;
-        Vertex vertices[LENGTH];
+    //! Where bitmaps go in one of the sprite textures. Bitmaps are placed
+    //! in rows, and space left over next to them is kept for smaller ones.
+    struct SpritePage {
+        GLshort width = 0;
+        GLshort height = 0;
+        AtlasFormat format = AtlasFormat::RGBA8;
+
+        QuadTree<std::size_t, Leftover> leftovers{compare_leftovers};
+        std::size_t rlid = 1;
+        std::size_t wasted = 0;
+        Point<GLshort> border;
+        Range<GLshort> y_range;
+
+        //! Find a place for a bitmap of `w` by `h` pixels, after aligning.
+        //! Returns false if the page is full.
+        bool place(GLshort w, GLshort h, Point<GLshort>& position);
+        void clear();
+        //! How much of the page is used, in percent.
+        float get_usage() const noexcept;
+    };
 
-        Quad(GLshort l,
-             GLshort r,
-             GLshort t,
-             GLshort b,
-             const Offset& o,
-             const Color& color,
-             GLfloat rot)
-        {
-            vertices[0] = {l, t, o.l, o.t, color};
-            vertices[1] = {l, b, o.l, o.b, color};
-            vertices[2] = {r, b, o.r, o.b, color};
-            vertices[3] = {r, t, o.r, o.t, color};
-
-            if (rot != 0.0f) {
-                float cos = std::cos(rot);
-                float sin = std::sin(rot);
-                GLshort cx = (l + r) / 2;
-                GLshort cy = (t + b) / 2;
-
-                for (int i = 0; i < 4; ++i) {
-                    GLshort vx = vertices[i].x - cx;
-                    GLshort vy = vertices[i].y - cy;
-                    GLfloat rx = std::roundf(vx * cos - vy * sin);
-                    GLfloat ry = std::roundf(vx * sin + vy * cos);
-                    vertices[i].x = static_cast<GLshort>(rx + cx);
-                    vertices[i].y = static_cast<GLshort>(ry + cy);
-                }
-            }
-        }
+    static QuadTree<std::size_t, Leftover>::Direction
+    compare_leftovers(const Leftover& first, const Leftover& second);
+
+    //! Everything needed to draw one frame.
+    struct Frame {
+        std::vector<Quad> quads;
+        std::vector<std::uint64_t> keys;
+        std::vector<Upload> uploads;
+        float opacity = 1.0f;
+        bool reinit = false;
+        std::int16_t width = 0;
+        std::int16_t height = 0;
     };
 
+    //! Add a quad to the scene, with a sort key for the current state.
+    template<typename... Args>
+    void add_quad(Args&&... args);
+    //! Add a quad which is drawn from the sprite texture `page`.
+    template<typename... Args>
+    void add_sprite_quad(RenderBackend::Page page, Args&&... args);
+    //! Draw the quads in the order of their keys on top of a cleared
+    //! screen.
+    void draw_quads(const std::vector<Quad>& frame_quads,
+                    const std::vector<std::uint64_t>& frame_keys,
+                    float opacity);
+    void render_loop(GLFWwindow* window);
+
     struct Font {
         struct Char {
             GLshort ax;
@@ -225,6 +293,11 @@ private:
         FT_Face face;
         // GLshort width;
         GLshort height;
+        //! For distance field fonts, the face the glyphs are shared with
+        //! and how much they are scaled. A scale of 0 means the font has
+        //! glyph bitmaps of its own.
+        Face sdf_face = NORMAL;
+        float sdf_scale = 0.0f;
 
         Font(FT_Face face_, GLshort h = 0) noexcept : face{face_}, height{h}
         {
@@ -246,73 +319,69 @@ private:
                    + static_cast<std::int16_t>(1);
         }
 
-        void add_char(char32_t c,
-                      GLshort ax,
-                      GLshort ay,
-                      GLshort bw,
-                      GLshort bh,
-                      GLshort bl,
-                      GLshort bt,
-                      Offset offset) noexcept
+        nullable_ptr<Char> add_char(char32_t c,
+                                    GLshort ax,
+                                    GLshort ay,
+                                    GLshort bw,
+                                    GLshort bh,
+                                    GLshort bl,
+                                    GLshort bt,
+                                    Offset offset) noexcept
         {
-            chars.try_emplace(c, ax, ay, bw, bh, bl, bt, offset);
+            auto [iter, _]
+                = chars.try_emplace(c, ax, ay, bw, bh, bl, bt, offset);
+            return &iter->second;
         }
 
-        nullable_ptr<Char> get_or_insert_char(char32_t c) noexcept
+        nullable_ptr<Char> find_char(char32_t c) noexcept
         {
             if (auto iter = chars.find(c); iter != chars.end()) {
                 return &iter->second;
             }
 
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-                return {};
-            }
-
-            const auto g = face->glyph;
-
-            GLshort ax = static_cast<GLshort>(g->advance.x >> 6);
-            GLshort ay = static_cast<GLshort>(g->advance.y >> 6);
-            GLshort l = static_cast<GLshort>(g->bitmap_left);
-            GLshort t = static_cast<GLshort>(g->bitmap_top);
-            GLshort w = static_cast<GLshort>(g->bitmap.width);
-            GLshort h = static_cast<GLshort>(g->bitmap.rows);
-
-            auto& ggl = GraphicsGL::get();
-
-            if (ggl.font_border.x() + w > ATLASW) {
-                ggl.font_border.set_x(0);
-                ggl.font_border.shift_y(ggl.font_y_max);
-            }
+            return {};
+        }
 
-            if (h > ggl.font_y_max) {
-                ggl.font_y_max = h;
-            }
-            if (h > height) {
-                height = h;
+        nullable_ptr<Char> get_or_insert_char(char32_t c) noexcept
+        {
+            if (auto ch = find_char(c)) {
+                return ch;
             }
 
-            glTexSubImage2D(GL_TEXTURE_2D,
-                            0,
-                            ggl.font_border.x(),
-                            ggl.font_border.y(),
-                            w,
-                            h,
-                            GL_RED,
-                            GL_UNSIGNED_BYTE,
-                            g->bitmap.buffer);
-
-            Offset offset{ggl.font_border.x(), ggl.font_border.y(), w, h};
-            auto [iter, _] = chars.try_emplace(c, ax, ay, w, h, l, t, offset);
-
-            ggl.font_border.shift_x(w);
-
-            return &iter->second;
+            return GraphicsGL::get().insert_glyph(*this, c);
         }
 
     private:
         std::unordered_map<char32_t, Char> chars;
     };
 
+    //! Rasterize a glyph which is not in the glyph page yet, right away.
+    nullable_ptr<Font::Char> insert_glyph(Font& font, char32_t c);
+    //! Add a rasterized glyph to the glyph page and to its font.
+    nullable_ptr<Font::Char> add_glyph(Font& font,
+                                       const GlyphRasterizer::Glyph& glyph);
+    //! Add a glyph for a distance field font, scaled from the glyph of its
+    //! face, which is rendered first if needed.
+    nullable_ptr<Font::Char> insert_sdf_glyph(Font& font, char32_t c);
+    //! Copy a glyph into the glyph page and queue its upload.
+    bool place_glyph(const GlyphRasterizer::Glyph& glyph,
+                     Point<GLshort>& position);
+
+    //! A distance field glyph, shared by all fonts of a face.
+    struct SdfGlyph {
+        GLshort ax;
+        GLshort ay;
+        GLshort l;
+        GLshort t;
+        GLshort w;
+        GLshort h;
+        Offset offset;
+    };
+
+    //! Add a distance field glyph of `face` to the glyph page.
+    const SdfGlyph* add_sdf_glyph(Face face,
+                                  const GlyphRasterizer::Glyph& glyph);
+
     class LayoutBuilder
     {
     public:
@@ -354,38 +423,81 @@ private:
 
     static Rectangle<std::int16_t> screen;
 
-    static constexpr const GLshort ATLASW = 8192;
-    static constexpr const GLshort ATLASH = 8192;
+    //! The width and height of the sprite atlas, and of the smaller one
+    //! used in low quality mode.
+    static constexpr const GLshort ATLAS_SIZE = 8192;
+    static constexpr const GLshort LOW_QUALITY_ATLAS_SIZE = 4096;
     static constexpr const GLshort MINLOSIZE = 32;
 
     bool locked;
 
     std::vector<Quad> quads;
-    GLuint vbo;
-    GLuint atlas;
-
-    GLint program;
-    GLint attribute_coord;
-    GLint attribute_color;
-    GLint uniform_texture;
-    GLint uniform_atlas_size;
-    GLint uniform_screen_size;
-    GLint uniform_y_offset;
-    GLint uniform_font_region;
-
-    std::unordered_map<std::size_t, Offset> offsets;
-    Offset null_offset;
+    //! The sort key of each quad.
+    std::vector<std::uint64_t> keys;
+    SpriteBatcher::Layer layer;
+    SpriteBatcher::Blend blend;
+    SpriteBatcher::Depths depths;
 
-    QuadTree<std::size_t, Leftover> leftovers;
-    std::size_t rlid;
-    std::size_t wasted;
-    Point<GLshort> border;
-    Range<GLshort> y_range;
+    //! Only used by the thread owning the context.
+    SpriteBatcher batcher;
+    std::vector<Quad> sorted_quads;
+    std::vector<SpriteBatcher::DrawCall> frame_calls;
+    std::atomic<std::uint32_t> draw_calls;
+    std::unique_ptr<RenderBackend> backend;
+
+
+    std::unordered_map<std::size_t, Placement> offsets;
+    Offset null_offset;
+    Placement null_placement;
+    RenderBackend::Atlas atlas;
+    SpritePage sprite_page;
+    SpritePage gradient_page;
+    BitmapDecoder decoder;
+    std::vector<BitmapDecoder::Bitmap> decoded;
+    //! Bitmaps which are being decoded, and have no place in the atlas yet.
+    std::unordered_set<std::size_t> loading;
+    //! Bitmaps which could not be decoded, and are never drawn.
+    std::unordered_set<std::size_t> broken;
+    //! Most bytes of bitmaps uploaded per frame, or 0 for no limit.
+    std::size_t upload_budget;
+    //! Whether the atlas was cleared and the bitmaps requested since are
+    //! not all uploaded yet. Until then, they are uploaded without a limit.
+    bool refilling;
 
     FT_Library ft_library;
     Font fonts[Text::NUM_FONTS];
-    Point<GLshort> font_border;
-    GLshort font_y_max;
+    std::array<GlyphRasterizer::Source, Text::NUM_FONTS> font_sources;
+
+    //! Whether fonts are drawn from distance fields shared between all
+    //! sizes of a face, instead of bitmaps for each size.
+    bool sdf_enabled;
+    std::array<FT_Face, NUM_FACES> sdf_faces;
+    std::array<GlyphRasterizer::Source, NUM_FACES> sdf_sources;
+    std::array<std::unordered_map<char32_t, SdfGlyph>, NUM_FACES> sdf_glyphs;
+
+    GlyphAtlas glyph_atlas;
+    GlyphRasterizer rasterizer;
+    //! Glyphs from the rasterizer which were not added to the page yet.
+    std::vector<GlyphRasterizer::Glyph> rasterized;
+    //! Most glyphs added from the rasterizer in a single frame.
+    static constexpr std::size_t MAX_GLYPHS_PER_FRAME = 256;
+    //! Rows of the glyph page which glyphs rendered ahead of time may take.
+    //! The rest is left for glyphs rendered when they are first used.
+    static constexpr GLshort MAX_PREWARM_HEIGHT = GlyphAtlas::MAX_HEIGHT / 2;
+
+    //! Uploads of the frame being recorded.
+    std::vector<Upload> uploads;
+    bool reinit_pending;
+
+    std::thread render_thread;
+    GLFWwindow* render_window = nullptr;
+    std::mutex frame_mutex;
+    std::condition_variable frame_ready;
+    //! The frame handed over to the render thread, while the next one is
+    //! recorded into `quads` and `uploads`.
+    Frame next_frame;
+    bool has_next_frame;
+    bool render_stop;
 };
 
 // constexpr Rectangle<std::int16_t> GraphicsGL::screen;
@@ -0,0 +1,235 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "NullBackend.h"
+
+#include "GlyphAtlas.h"
+
+#include <iomanip>
+
+namespace jrc
+{
+namespace
+{
+constexpr std::uint64_t FNV_OFFSET = 14'695'981'039'346'656'037ull;
+constexpr std::uint64_t FNV_PRIME = 1'099'511'628'211ull;
+} // namespace
+
+NullBackend::NullBackend() noexcept
+    : atlas{},
+      frame_hash{FNV_OFFSET},
+      width{0},
+      height{0},
+      glyph_page_height{0}
+{
+}
+
+Error NullBackend::init(Atlas& new_atlas, bool)
+{
+    atlas = new_atlas;
+    glyph_page_height = GlyphAtlas::INITIAL_HEIGHT;
+
+    return Error::NONE;
+}
+
+void NullBackend::resize(std::int16_t new_width, std::int16_t new_height)
+{
+    width = new_width;
+    height = new_height;
+}
+
+void NullBackend::upload(const std::vector<Upload>& pending)
+{
+    for (const Upload& up : pending) {
+        ++stats.uploads;
+        stats.upload_bytes += up.pixels.size();
+
+        GLshort page_width = atlas.get_width(up.page);
+        GLshort page_height = atlas.get_height(up.page);
+        std::size_t size = texture_encoding::get_size(
+            atlas.get_format(up.page), up.w, up.h);
+        if (up.page == GRADIENTS) {
+            ++stats.gradient_uploads;
+            if (!atlas.gradient_page) {
+                ++stats.invalid;
+            }
+        } else if (up.page == GLYPHS) {
+            while (glyph_page_height < up.y + up.h) {
+                glyph_page_height *= 2;
+            }
+
+            page_width = GlyphAtlas::WIDTH;
+            page_height = glyph_page_height;
+            size = static_cast<std::size_t>(up.w) * up.h;
+        }
+
+        bool in_page = up.x >= 0 && up.y >= 0 && up.x + up.w <= page_width
+                       && up.y + up.h <= page_height;
+        if (!in_page || up.pixels.size() < size) {
+            ++stats.invalid;
+        }
+    }
+}
+
+void NullBackend::draw(const std::vector<Quad>& quads,
+                       const std::vector<SpriteBatcher::DrawCall>& calls)
+{
+    ++stats.frames;
+    stats.quads += quads.size();
+    stats.draw_calls += calls.size();
+
+    // The calls have to draw every quad exactly once, in order.
+    std::uint32_t next = 0;
+    for (const SpriteBatcher::DrawCall& call : calls) {
+        if (call.first != next) {
+            ++stats.invalid;
+        }
+
+        next = call.first + call.count;
+        if (next > quads.size()) {
+            break;
+        }
+
+        auto page = static_cast<Page>(call.page);
+        for (std::uint32_t i = call.first; i < next; ++i) {
+            if (!is_valid(quads[i], page)) {
+                ++stats.invalid;
+            }
+        }
+    }
+    if (next != quads.size()) {
+        ++stats.invalid;
+    }
+
+    hash(quads.data(), quads.size() * sizeof(Quad));
+    for (const SpriteBatcher::DrawCall& call : calls) {
+        hash(&call.first, sizeof(call.first));
+        hash(&call.count, sizeof(call.count));
+        hash(&call.page, sizeof(call.page));
+        hash(&call.blend, sizeof(call.blend));
+    }
+
+    last_frame = quads;
+    last_calls = calls;
+}
+
+void NullBackend::report(std::ostream& os)
+{
+    double frames = stats.frames > 0 ? static_cast<double>(stats.frames) : 1.0;
+
+    static constexpr const char* FORMATS[] = {"RGBA8", "RGBA4", "BC3"};
+    auto print_page = [&](const char* name, Page page) {
+        GLshort page_width = atlas.get_width(page);
+        GLshort page_height = atlas.get_height(page);
+        AtlasFormat format = atlas.get_format(page);
+        std::size_t size
+            = texture_encoding::get_size(format, page_width, page_height);
+        os << name << page_width << 'x' << page_height << ' '
+           << FORMATS[static_cast<std::size_t>(format)] << " ("
+           << size / (1024 * 1024) << " MiB)\n";
+    };
+
+    os << "Frames drawn: " << stats.frames << '\n';
+    print_page("    atlas                 ", SPRITES);
+    if (atlas.gradient_page) {
+        print_page("    gradient atlas        ", GRADIENTS);
+        os << "    gradient uploads      " << stats.gradient_uploads << '\n';
+    }
+
+    os << std::fixed << std::setprecision(1)
+       << "    quads per frame       " << stats.quads / frames << '\n'
+       << "    draw calls per frame  " << stats.draw_calls / frames << '\n'
+       << "    uploads               " << stats.uploads << " ("
+       << stats.upload_bytes / 1024 << " KiB)\n"
+       << "    out of bounds         " << stats.invalid << '\n'
+       << "    hash                  " << std::hex << std::setw(16)
+       << std::setfill('0') << frame_hash << std::dec << std::setfill(' ')
+       << '\n';
+}
+
+const NullBackend::Stats& NullBackend::get_stats() const noexcept
+{
+    return stats;
+}
+
+const std::vector<RenderBackend::Quad>&
+NullBackend::get_last_frame() const noexcept
+{
+    return last_frame;
+}
+
+const std::vector<SpriteBatcher::DrawCall>&
+NullBackend::get_last_draw_calls() const noexcept
+{
+    return last_calls;
+}
+
+std::uint64_t NullBackend::get_hash() const noexcept
+{
+    return frame_hash;
+}
+
+bool NullBackend::is_valid(const Quad& quad, Page page) const noexcept
+{
+    GLshort page_width = atlas.get_width(page);
+    GLshort page_height = atlas.get_height(page);
+
+    for (const Quad::Vertex& vertex : quad.vertices) {
+        // The coordinates of a repeated sprite wrap around, so only the
+        // sprite itself has to be in the atlas.
+        const Tile& tile = vertex.tile;
+        if (tile.w > 0) {
+            if (tile.x < 0 || tile.y < 0 || tile.h <= 0
+                || tile.x + tile.w > page_width
+                || tile.y + tile.h > page_height) {
+                return false;
+            }
+
+            continue;
+        }
+
+        GLshort s = vertex.s;
+        GLshort t = vertex.t;
+
+        // See the fragment shader in `GLBackend` for what the texture
+        // coordinates mean.
+        if (t == 0) {
+            continue;
+        } else if (t < 0) {
+            if (s < 0) {
+                s = -s - 1;
+            }
+
+            if (s > GlyphAtlas::WIDTH || -t - 1 > glyph_page_height) {
+                return false;
+            }
+        } else if (s < 0 || s > page_width || t > page_height) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void NullBackend::hash(const void* data, std::size_t length) noexcept
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < length; ++i) {
+        frame_hash = (frame_hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+} // namespace jrc
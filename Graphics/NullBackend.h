@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "RenderBackend.h"
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace jrc
+{
+//! Draws nothing, but counts and checks what it is given, for running
+//! without a display. The hash of the frames drawn stays the same from one
+//! run to the next as long as the frames do.
+class NullBackend : public RenderBackend
+{
+public:
+    //! Totals since startup.
+    struct Stats {
+        std::uint64_t frames = 0;
+        std::uint64_t quads = 0;
+        std::uint64_t draw_calls = 0;
+        std::uint64_t uploads = 0;
+        std::uint64_t upload_bytes = 0;
+        //! Uploads to the page for sprites with gradients.
+        std::uint64_t gradient_uploads = 0;
+        //! Quads, draw calls and uploads which were out of bounds.
+        std::uint64_t invalid = 0;
+    };
+
+    NullBackend() noexcept;
+
+    Error init(Atlas& atlas, bool linear_glyphs) override;
+    void resize(std::int16_t width, std::int16_t height) override;
+    void upload(const std::vector<Upload>& pending) override;
+    void draw(const std::vector<Quad>& quads,
+              const std::vector<SpriteBatcher::DrawCall>& calls) override;
+    void report(std::ostream& os) override;
+
+    const Stats& get_stats() const noexcept;
+    //! The quads of the last frame, in the order they were drawn.
+    const std::vector<Quad>& get_last_frame() const noexcept;
+    const std::vector<SpriteBatcher::DrawCall>&
+    get_last_draw_calls() const noexcept;
+    //! A hash of every frame drawn so far.
+    std::uint64_t get_hash() const noexcept;
+
+private:
+    //! Whether the texture coordinates of the quad are in their texture,
+    //! for a quad drawn from `page`.
+    bool is_valid(const Quad& quad, Page page) const noexcept;
+    void hash(const void* data, std::size_t length) noexcept;
+
+    Atlas atlas;
+    Stats stats;
+    std::vector<Quad> last_frame;
+    std::vector<SpriteBatcher::DrawCall> last_calls;
+    std::uint64_t frame_hash;
+    std::int16_t width;
+    std::int16_t height;
+    //! The height the glyph texture would have.
+    GLshort glyph_page_height;
+};
+} // namespace jrc
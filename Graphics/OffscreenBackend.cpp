@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "OffscreenBackend.h"
+#ifdef JOURNEY_USE_OSMESA
+#    include "../Constants.h"
+
+#    include <fstream>
+
+namespace jrc
+{
+OffscreenBackend::OffscreenBackend() noexcept
+    : context{nullptr},
+      width{Constants::VIEW_WIDTH},
+      height{Constants::VIEW_HEIGHT}
+{
+}
+
+OffscreenBackend::~OffscreenBackend()
+{
+    if (context) {
+        OSMesaDestroyContext(context);
+    }
+}
+
+Error OffscreenBackend::init(Atlas& atlas, bool linear_glyphs)
+{
+    context = OSMesaCreateContextExt(OSMESA_RGBA, 0, 0, 0, nullptr);
+    if (!context) {
+        return Error::WINDOW;
+    }
+
+    pixels.resize(4 * width * height);
+    if (!OSMesaMakeCurrent(
+            context, pixels.data(), GL_UNSIGNED_BYTE, width, height)) {
+        return Error::WINDOW;
+    }
+
+    return GLBackend::init(atlas, linear_glyphs);
+}
+
+void OffscreenBackend::resize(std::int16_t new_width, std::int16_t new_height)
+{
+    // The context draws straight into the buffer, so it has to be bound
+    // again whenever the buffer changes.
+    width = new_width;
+    height = new_height;
+    pixels.resize(4 * width * height);
+    OSMesaMakeCurrent(context, pixels.data(), GL_UNSIGNED_BYTE, width, height);
+
+    GLBackend::resize(width, height);
+}
+
+void OffscreenBackend::present()
+{
+    glFinish();
+}
+
+void OffscreenBackend::report(std::ostream& os)
+{
+    if (write_tga("frame.tga")) {
+        os << "Wrote the last frame to \"frame.tga\".\n";
+    } else {
+        os << "Could not write \"frame.tga\".\n";
+    }
+}
+
+bool OffscreenBackend::write_tga(const std::string& path) const
+{
+    std::ofstream file{path, std::ios::binary};
+    if (!file) {
+        return false;
+    }
+
+    // An uncompressed true-color image with 8 bits of alpha, from the
+    // bottom row up like the buffer.
+    unsigned char header[18] = {};
+    header[2] = 2;
+    header[12] = static_cast<unsigned char>(width & 0xFF);
+    header[13] = static_cast<unsigned char>(width >> 8);
+    header[14] = static_cast<unsigned char>(height & 0xFF);
+    header[15] = static_cast<unsigned char>(height >> 8);
+    header[16] = 32;
+    header[17] = 8;
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    std::vector<unsigned char> bgra{pixels};
+    for (std::size_t i = 0; i + 3 < bgra.size(); i += 4) {
+        std::swap(bgra[i], bgra[i + 2]);
+    }
+    file.write(reinterpret_cast<const char*>(bgra.data()),
+               static_cast<std::streamsize>(bgra.size()));
+
+    return static_cast<bool>(file);
+}
+} // namespace jrc
+#endif
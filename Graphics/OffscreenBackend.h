@@ -0,0 +1,55 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Journey.h"
+
+#ifdef JOURNEY_USE_OSMESA
+#    include "GL/osmesa.h"
+#    include "GLBackend.h"
+
+#    include <string>
+
+namespace jrc
+{
+//! Renders with OpenGL into memory, using OSMesa's software rasterizer, for
+//! running without a display or GPU. GLEW has to be built with OSMesa
+//! support (`GLEW_OSMESA`) for this.
+class OffscreenBackend : public GLBackend
+{
+public:
+    OffscreenBackend() noexcept;
+    ~OffscreenBackend() override;
+
+    Error init(Atlas& atlas, bool linear_glyphs) override;
+    void resize(std::int16_t width, std::int16_t height) override;
+    void present() override;
+    //! Write the last frame to "frame.tga".
+    void report(std::ostream& os) override;
+
+    //! Write the last frame as an uncompressed TGA image.
+    bool write_tga(const std::string& path) const;
+
+private:
+    OSMesaContext context;
+    //! The frame, in RGBA and from the bottom row up.
+    std::vector<unsigned char> pixels;
+    std::int16_t width;
+    std::int16_t height;
+};
+} // namespace jrc
+#endif
@@ -0,0 +1,192 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Error.h"
+#include "Color.h"
+#include "GL/glew.h"
+#include "SpriteBatcher.h"
+#include "TextureEncoding.h"
+
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace jrc
+{
+//! Draws the frames recorded by `GraphicsGL`.
+//!
+//! The scene is recorded as a list of textured quads and the pixels which
+//! have to be copied into the textures first. A backend only has to upload
+//! those and draw the quads, which allows running without a window: the
+//! null backend only records and checks the frames, and the offscreen
+//! backend renders them in software.
+class RenderBackend
+{
+public:
+    //! The textures which pixels are uploaded to.
+    enum Page : std::uint8_t { SPRITES, GLYPHS, GRADIENTS };
+
+    //! The size and format of the sprite textures.
+    struct Atlas {
+        GLshort width;
+        GLshort height;
+        AtlasFormat format;
+        //! Whether sprites which would band in `format` go to a texture of
+        //! their own, with half the width and height, in RGBA8.
+        bool gradient_page;
+
+        GLshort get_width(Page page) const noexcept
+        {
+            return page == GRADIENTS ? width / 2 : width;
+        }
+
+        GLshort get_height(Page page) const noexcept
+        {
+            return page == GRADIENTS ? height / 2 : height;
+        }
+
+        AtlasFormat get_format(Page page) const noexcept
+        {
+            return page == GRADIENTS ? AtlasFormat::RGBA8 : format;
+        }
+    };
+
+    //! Texture coordinates of a quad.
+    struct Offset {
+        GLshort l;
+        GLshort r;
+        GLshort t;
+        GLshort b;
+
+        Offset(GLshort x, GLshort y, GLshort w, GLshort h) noexcept
+            : l{x}, r{x + w}, t{y}, b{y + h}
+        {
+        }
+
+        Offset() noexcept : l{0}, r{0}, t{0}, b{0}
+        {
+        }
+    };
+
+    //! A rectangle of the atlas which texture coordinates wrap around in.
+    struct Tile {
+        GLshort x;
+        GLshort y;
+        GLshort w;
+        GLshort h;
+    };
+
+    struct Quad {
+        struct Vertex {
+            GLshort x;
+            GLshort y;
+            GLshort s;
+            GLshort t;
+
+            Color c;
+            //! All zero unless the quad repeats a sprite.
+            Tile tile;
+        };
+
+        static const std::size_t LENGTH = 4;
+        Vertex vertices[LENGTH];
+
+        Quad(GLshort l,
+             GLshort r,
+             GLshort t,
+             GLshort b,
+             const Offset& o,
+             const Color& color,
+             GLfloat rot)
+        {
+            vertices[0] = {l, t, o.l, o.t, color, {}};
+            vertices[1] = {l, b, o.l, o.b, color, {}};
+            vertices[2] = {r, b, o.r, o.b, color, {}};
+            vertices[3] = {r, t, o.r, o.t, color, {}};
+
+            if (rot != 0.0f) {
+                float cos = std::cos(rot);
+                float sin = std::sin(rot);
+                GLshort cx = (l + r) / 2;
+                GLshort cy = (t + b) / 2;
+
+                for (int i = 0; i < 4; ++i) {
+                    GLshort vx = vertices[i].x - cx;
+                    GLshort vy = vertices[i].y - cy;
+                    GLfloat rx = std::roundf(vx * cos - vy * sin);
+                    GLfloat ry = std::roundf(vx * sin + vy * cos);
+                    vertices[i].x = static_cast<GLshort>(rx + cx);
+                    vertices[i].y = static_cast<GLshort>(ry + cy);
+                }
+            }
+        }
+
+        //! Repeat the sprite at `sprite` over the quad. The texture
+        //! coordinates then count pixels from the corner of a repetition.
+        void repeat(const Offset& sprite) noexcept
+        {
+            Tile tile{sprite.l,
+                      sprite.t,
+                      static_cast<GLshort>(sprite.r - sprite.l),
+                      static_cast<GLshort>(sprite.b - sprite.t)};
+            for (Vertex& vertex : vertices) {
+                vertex.tile = tile;
+            }
+        }
+    };
+
+    //! Pixels which still have to be copied into a texture. Bitmaps and
+    //! glyphs are only uploaded when the frame using them is drawn, so that
+    //! all GL calls are made by the thread owning the context.
+    struct Upload {
+        GLshort x;
+        GLshort y;
+        GLshort w;
+        GLshort h;
+        GLenum format;
+        std::vector<unsigned char> pixels;
+        Page page = SPRITES;
+        //! Ignored for compressed formats.
+        GLenum type = GL_UNSIGNED_BYTE;
+    };
+
+    virtual ~RenderBackend() = default;
+
+    //! Create the textures and whatever else is needed for drawing. Glyphs
+    //! are filtered linearly if `linear_glyphs` is set, for distance fields.
+    //! The format of `atlas` is changed if it is not supported.
+    virtual Error init(Atlas& atlas, bool linear_glyphs) = 0;
+    //! Adapt to a new screen size.
+    virtual void resize(std::int16_t width, std::int16_t height) = 0;
+    //! Copy the pixels into their textures.
+    virtual void upload(const std::vector<Upload>& pending) = 0;
+    //! Draw the quads on a cleared screen with one call each of `calls`.
+    virtual void draw(const std::vector<Quad>& quads,
+                      const std::vector<SpriteBatcher::DrawCall>& calls)
+        = 0;
+    //! Called when a frame is done. Windows present their frames themselves.
+    virtual void present()
+    {
+    }
+    //! Called once the game loop has ended, to report on the frames drawn.
+    virtual void report(std::ostream&)
+    {
+    }
+};
+} // namespace jrc
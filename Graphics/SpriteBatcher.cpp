@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "SpriteBatcher.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace jrc
+{
+namespace
+{
+bool overlap(const SpriteBatcher::Bounds& a,
+             const SpriteBatcher::Bounds& b) noexcept
+{
+    // Quads which only touch can still be drawn in any order.
+    return a.l < b.r && b.l < a.r && a.t < b.b && b.t < a.b;
+}
+
+SpriteBatcher::Bounds merge(const SpriteBatcher::Bounds& a,
+                            const SpriteBatcher::Bounds& b) noexcept
+{
+    return {std::min(a.l, b.l),
+            std::max(a.r, b.r),
+            std::min(a.t, b.t),
+            std::max(a.b, b.b)};
+}
+
+std::int64_t area(const SpriteBatcher::Bounds& bounds) noexcept
+{
+    return std::int64_t{bounds.r - bounds.l} * (bounds.b - bounds.t);
+}
+} // namespace
+
+SpriteBatcher::Depths::Depths() noexcept : depth{0}
+{
+}
+
+void SpriteBatcher::Depths::clear() noexcept
+{
+    areas.clear();
+    depth = 0;
+}
+
+std::uint32_t
+SpriteBatcher::Depths::next(std::uint8_t page, Blend blend, Bounds bounds)
+{
+    const auto state = static_cast<std::uint16_t>(page << 8 | blend);
+
+    for (const Area& covered : areas) {
+        if (covered.state != state && overlap(covered.bounds, bounds)) {
+            areas.clear();
+            if (depth < MAX_DEPTH) {
+                ++depth;
+            }
+
+            break;
+        }
+    }
+
+    // Grow whichever rectangle of this state grows the least.
+    Area* closest = nullptr;
+    std::size_t count = 0;
+    std::int64_t least_growth = 0;
+    for (Area& covered : areas) {
+        if (covered.state != state) {
+            continue;
+        }
+
+        ++count;
+        std::int64_t growth
+            = area(merge(covered.bounds, bounds)) - area(covered.bounds);
+        if (!closest || growth < least_growth) {
+            closest = &covered;
+            least_growth = growth;
+        }
+    }
+
+    if (closest && (least_growth == 0 || count == MAX_AREAS)) {
+        closest->bounds = merge(closest->bounds, bounds);
+    } else {
+        areas.push_back({state, bounds});
+    }
+
+    return depth;
+}
+
+std::uint64_t SpriteBatcher::make_key(Layer layer,
+                                      std::uint32_t depth,
+                                      std::uint8_t page,
+                                      Blend blend) noexcept
+{
+    return static_cast<std::uint64_t>(layer) << 56
+           | static_cast<std::uint64_t>(std::min(depth, MAX_DEPTH)) << 32
+           | static_cast<std::uint64_t>(page) << 24
+           | static_cast<std::uint64_t>(blend) << 16;
+}
+
+bool SpriteBatcher::sort(const std::vector<std::uint64_t>& keys)
+{
+    const auto count = static_cast<std::uint32_t>(keys.size());
+
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0);
+
+    // Quads are usually added in order already, and then nothing needs to
+    // be sorted.
+    bool reordered = !std::is_sorted(keys.begin(), keys.end());
+    if (reordered) {
+        // LSD radix sort, one byte at a time. A histogram of every byte is
+        // taken up front, so that passes over bytes which are the same in
+        // all keys can be skipped.
+        std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+        for (std::uint64_t key : keys) {
+            for (std::size_t byte = 0; byte < 8; ++byte) {
+                ++histograms[byte][(key >> (byte * 8)) & 0xFF];
+            }
+        }
+
+        scratch.resize(count);
+        for (std::size_t byte = 0; byte < 8; ++byte) {
+            auto& histogram = histograms[byte];
+            std::uint32_t first_bucket = (keys[0] >> (byte * 8)) & 0xFF;
+            if (histogram[first_bucket] == count) {
+                continue;
+            }
+
+            std::uint32_t offset = 0;
+            for (std::uint32_t& bucket : histogram) {
+                std::uint32_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+
+            for (std::uint32_t index : order) {
+                std::uint32_t bucket = (keys[index] >> (byte * 8)) & 0xFF;
+                scratch[histogram[bucket]++] = index;
+            }
+
+            order.swap(scratch);
+        }
+    }
+
+    draw_calls.clear();
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint64_t key = keys[order[i]];
+        auto page = static_cast<std::uint8_t>(key >> 24);
+        auto blend = static_cast<Blend>(key >> 16 & 0xFF);
+
+        if (draw_calls.empty() || draw_calls.back().page != page
+            || draw_calls.back().blend != blend) {
+            draw_calls.push_back({i, 0, page, blend});
+        }
+
+        ++draw_calls.back().count;
+    }
+
+    return reordered;
+}
+
+const std::vector<std::uint32_t>& SpriteBatcher::get_order() const noexcept
+{
+    return order;
+}
+
+const std::vector<SpriteBatcher::DrawCall>&
+SpriteBatcher::get_draw_calls() const noexcept
+{
+    return draw_calls;
+}
+} // namespace jrc
@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace jrc
+{
+//! Orders the quads of a frame by a 64-bit sort key and splits them into
+//! draw calls wherever the texture page or blend mode changes.
+//!
+//! From the most to the least significant bits, a key holds the layer, the
+//! depth, the texture page and the blend mode. Quads with the same depth
+//! are grouped by page and blend mode, so only quads which may be drawn in
+//! any order can share one. `Depths` hands those out.
+class SpriteBatcher
+{
+public:
+    //! Groups of quads drawn one after another, whatever order they were
+    //! added in.
+    enum Layer : std::uint8_t { WORLD, INTERFACE };
+    enum Blend : std::uint8_t { ALPHA, ADDITIVE };
+
+    //! A run of quads in sorted order which are drawn with one call.
+    struct DrawCall {
+        std::uint32_t first;
+        std::uint32_t count;
+        std::uint8_t page;
+        Blend blend;
+    };
+
+    //! The screen area covered by a quad.
+    struct Bounds {
+        std::int16_t l;
+        std::int16_t r;
+        std::int16_t t;
+        std::int16_t b;
+    };
+
+    //! Assigns depths to the quads of a frame in the order they are added.
+    //!
+    //! A quad shares the depth of the quads before it, unless it overlaps
+    //! one of them with another page or blend mode and so has to be drawn
+    //! after it. The areas covered at the current depth are kept as a few
+    //! rectangles per page and blend mode, which are merged when there are
+    //! too many. That only ever starts a new depth too early.
+    class Depths
+    {
+    public:
+        Depths() noexcept;
+
+        //! Start again from depth zero.
+        void clear() noexcept;
+        //! The depth of the next quad.
+        std::uint32_t next(std::uint8_t page, Blend blend, Bounds bounds);
+
+    private:
+        struct Area {
+            std::uint16_t state;
+            Bounds bounds;
+        };
+
+        //! Most rectangles kept for each page and blend mode.
+        static constexpr std::size_t MAX_AREAS = 8;
+
+        std::vector<Area> areas;
+        std::uint32_t depth;
+    };
+
+    //! The largest depth a key can hold.
+    static constexpr std::uint32_t MAX_DEPTH = (1u << 24) - 1;
+
+    static std::uint64_t make_key(Layer layer,
+                                  std::uint32_t depth,
+                                  std::uint8_t page,
+                                  Blend blend) noexcept;
+
+    //! Sort the quads with these keys, keeping the order of equal keys.
+    //! Returns whether any quad changed places.
+    bool sort(const std::vector<std::uint64_t>& keys);
+
+    //! The indices of the quads in the order they are drawn.
+    const std::vector<std::uint32_t>& get_order() const noexcept;
+    const std::vector<DrawCall>& get_draw_calls() const noexcept;
+
+private:
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> scratch;
+    std::vector<DrawCall> draw_calls;
+};
+} // namespace jrc
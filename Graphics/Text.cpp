@@ -19,6 +19,7 @@
 
 #include "../Util/Str.h"
 #include "GraphicsGL.h"
+#include "TextLayoutCache.h"
 
 namespace jrc
 {
@@ -33,6 +34,7 @@ Text::Text(Font f,
       alignment{a},
       color{c},
       background{b},
+      layout{TextLayoutCache::get().get_empty()},
       max_width{mw},
       formatted{fm}
 {
@@ -55,11 +57,7 @@ Text::Text() noexcept : Text(A11M, LEFT, BLACK)
 
 void Text::reset_layout() noexcept
 {
-    if (text.empty()) {
-        return;
-    }
-
-    layout = GraphicsGL::get().create_layout(
+    layout = TextLayoutCache::get().get_layout(
         text, font, alignment, max_width, formatted);
 }
 
@@ -81,8 +79,6 @@ void Text::change_color(Color c)
     }
 
     color = c;
-
-    reset_layout();
 }
 
 void Text::set_background(Background b)
@@ -92,12 +88,12 @@ void Text::set_background(Background b)
 
 void Text::draw(const DrawArgument& args) const
 {
-    GraphicsGL::get().draw_text(args, text, layout, font, color, background);
+    GraphicsGL::get().draw_text(args, text, *layout, font, color, background);
 }
 
 std::uint16_t Text::advance(std::size_t pos) const
 {
-    return static_cast<std::uint16_t>(layout.advance(pos));
+    return static_cast<std::uint16_t>(layout->advance(pos));
 }
 
 bool Text::empty() const
@@ -112,22 +108,22 @@ std::size_t Text::length() const
 
 std::int16_t Text::width() const
 {
-    return layout.width();
+    return layout->width();
 }
 
 std::int16_t Text::height() const
 {
-    return layout.height();
+    return layout->height();
 }
 
 Point<std::int16_t> Text::dimensions() const
 {
-    return layout.get_dimensions();
+    return layout->get_dimensions();
 }
 
 Point<std::int16_t> Text::endoffset() const
 {
-    return layout.get_endoffset();
+    return layout->get_endoffset();
 }
 
 const utf8_string& Text::get_text() const noexcept
@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace jrc
@@ -147,7 +148,8 @@ private:
     Alignment alignment;
     Color color;
     Background background;
-    Layout layout;
+    //! Shared with every other `Text` of the same string and parameters.
+    std::shared_ptr<const Layout> layout;
     std::uint16_t max_width;
     bool formatted;
     utf8_string text;
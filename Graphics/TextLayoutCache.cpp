@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "TextLayoutCache.h"
+
+#include "GraphicsGL.h"
+
+#include <functional>
+#include <string_view>
+
+namespace jrc
+{
+float TextLayoutCache::Stats::hit_rate() const noexcept
+{
+    std::uint64_t lookups = hits + misses;
+
+    return lookups == 0 ? 0.0f
+                        : static_cast<float>(hits)
+                              / static_cast<float>(lookups);
+}
+
+TextLayoutCache::TextLayoutCache() noexcept
+    : empty{std::make_shared<const Text::Layout>()},
+      hits{0},
+      misses{0},
+      evictions{0}
+{
+}
+
+TextLayoutCache::LayoutPtr
+TextLayoutCache::get_layout(const utf8_string& text,
+                            Text::Font font,
+                            Text::Alignment alignment,
+                            std::uint16_t max_width,
+                            bool formatted)
+{
+    if (text.empty()) {
+        return empty;
+    }
+
+    std::string_view bytes{text.data(), text.size()};
+
+    std::uint64_t key_hash = std::hash<std::string_view>{}(bytes);
+    std::uint64_t params = static_cast<std::uint64_t>(font)
+                           | static_cast<std::uint64_t>(alignment) << 8
+                           | static_cast<std::uint64_t>(max_width) << 16
+                           | static_cast<std::uint64_t>(formatted) << 32;
+    key_hash ^= params + 0x9e3779b97f4a7c15 + (key_hash << 6)
+                + (key_hash >> 2);
+
+    if (auto iter = index.find(key_hash); iter != index.end()) {
+        Entry& entry = *iter->second;
+        if (entry.font == font && entry.alignment == alignment
+            && entry.max_width == max_width && entry.formatted == formatted
+            && entry.text == bytes) {
+            ++hits;
+            entries.splice(entries.begin(), entries, iter->second);
+
+            return entry.layout;
+        }
+
+        entries.erase(iter->second);
+        index.erase(iter);
+    }
+
+    ++misses;
+
+    auto layout = std::make_shared<const Text::Layout>(
+        GraphicsGL::get().create_layout(
+            text, font, alignment, max_width, formatted));
+
+    entries.push_front({key_hash,
+                        std::string{bytes},
+                        font,
+                        alignment,
+                        max_width,
+                        formatted,
+                        layout});
+    index[key_hash] = entries.begin();
+
+    if (entries.size() > MAX_ENTRIES) {
+        index.erase(entries.back().key_hash);
+        entries.pop_back();
+        ++evictions;
+    }
+
+    return layout;
+}
+
+const TextLayoutCache::LayoutPtr& TextLayoutCache::get_empty() const noexcept
+{
+    return empty;
+}
+
+void TextLayoutCache::clear() noexcept
+{
+    entries.clear();
+    index.clear();
+}
+
+TextLayoutCache::Stats TextLayoutCache::get_stats() const noexcept
+{
+    return {hits, misses, evictions, entries.size()};
+}
+} // namespace jrc
@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Singleton.h"
+#include "Text.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace jrc
+{
+//! Shares text layouts between all `Text` objects with the same string and
+//! layout parameters.
+//!
+//! Layouts are immutable once created and handed out as shared pointers, so
+//! evicting one only drops the reference of the cache. The least recently
+//! used layout is evicted once `MAX_ENTRIES` are held. Like the rest of the
+//! text rendering, this is only used from the main thread.
+class TextLayoutCache : public Singleton<TextLayoutCache>
+{
+public:
+    using LayoutPtr = std::shared_ptr<const Text::Layout>;
+
+    struct Stats {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+        std::size_t entries;
+
+        //! Fraction of lookups that were hits, or 0 before the first one.
+        float hit_rate() const noexcept;
+    };
+
+    TextLayoutCache() noexcept;
+
+    //! Return the layout for `text`, creating it on a miss.
+    LayoutPtr get_layout(const utf8_string& text,
+                         Text::Font font,
+                         Text::Alignment alignment,
+                         std::uint16_t max_width,
+                         bool formatted);
+    //! The layout of the empty string.
+    const LayoutPtr& get_empty() const noexcept;
+
+    //! Drop all layouts, for example after the font sizes changed.
+    void clear() noexcept;
+
+    Stats get_stats() const noexcept;
+
+private:
+    struct Entry {
+        std::uint64_t key_hash;
+        std::string text;
+        Text::Font font;
+        Text::Alignment alignment;
+        std::uint16_t max_width;
+        bool formatted;
+        LayoutPtr layout;
+    };
+
+    static constexpr std::size_t MAX_ENTRIES = 2048;
+
+    //! Most recently used first.
+    std::list<Entry> entries;
+    //! Entries by the hash of their whole key. Two keys with the same hash
+    //! replace each other, which is rare enough not to matter.
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    LayoutPtr empty;
+
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t evictions;
+};
+} // namespace jrc
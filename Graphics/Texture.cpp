@@ -18,8 +18,9 @@
 #include "Texture.h"
 
 #include "../Configuration.h"
+#include "../Util/NxPath.h"
 #include "GraphicsGL.h"
-#include "nlnx/nx.hpp"
+#include "nlnx/node.hpp"
 
 namespace jrc
 {
@@ -33,12 +34,7 @@ Texture::Texture(nl::node src)
 
         const std::string link = src["source"];
         if (!link.empty()) {
-            nl::node src_file = src;
-            while (src_file != src_file.root()) {
-                src_file = src_file.root();
-            }
-            src = src_file.resolve(
-                std::string_view{link}.substr(link.find('/') + 1));
+            src = NodeCache::get().link(src, link);
         }
 
         bitmap = src;
@@ -71,6 +67,22 @@ void Texture::draw(const DrawArgument& args) const
                            args.get_angle());
 }
 
+void Texture::draw_tiled(const DrawArgument& args,
+                         Point<std::int16_t> spacing,
+                         Point<std::int16_t> count) const
+{
+    std::size_t id = bitmap.id();
+    if (id == 0) {
+        return;
+    }
+
+    GraphicsGL::get().draw_tiled(bitmap,
+                                 args.get_rectangle(origin, dimensions),
+                                 spacing,
+                                 count,
+                                 args.get_color());
+}
+
 void Texture::shift(Point<std::int16_t> amount)
 {
     origin -= amount;
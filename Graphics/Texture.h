@@ -32,6 +32,10 @@ public:
     ~Texture();
 
     void draw(const DrawArgument& args) const;
+    //! Draw `count` copies in each direction, `spacing` pixels apart.
+    void draw_tiled(const DrawArgument& args,
+                    Point<std::int16_t> spacing,
+                    Point<std::int16_t> count) const;
     void shift(Point<std::int16_t> amount);
 
     bool is_valid() const;
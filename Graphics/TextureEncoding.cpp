@@ -0,0 +1,340 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "TextureEncoding.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace jrc
+{
+namespace texture_encoding
+{
+namespace
+{
+constexpr GLshort BLOCK_SIZE = 4;
+//! The difference between neighbouring values of a channel with 4 bits.
+constexpr int RGBA4_STEP = 17;
+
+//! Round an 8-bit channel to `bits` bits.
+std::uint32_t quantize(std::uint32_t value, std::uint32_t bits) noexcept
+{
+    std::uint32_t max = (1u << bits) - 1;
+    return (value * max + 127) / 255;
+}
+
+std::uint16_t to_rgb565(const std::array<std::int32_t, 3>& rgb) noexcept
+{
+    return static_cast<std::uint16_t>(quantize(rgb[0], 5) << 11
+                                      | quantize(rgb[1], 6) << 5
+                                      | quantize(rgb[2], 5));
+}
+
+std::array<std::int32_t, 3> from_rgb565(std::uint16_t color) noexcept
+{
+    std::int32_t r = color >> 11 & 0x1F;
+    std::int32_t g = color >> 5 & 0x3F;
+    std::int32_t b = color & 0x1F;
+
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+void encode_rgba4(const unsigned char* bgra,
+                  std::size_t count,
+                  std::vector<unsigned char>& out)
+{
+    out.resize(2 * count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const unsigned char* pixel = bgra + 4 * i;
+        auto packed = static_cast<std::uint16_t>(
+            quantize(pixel[2], 4) << 12 | quantize(pixel[1], 4) << 8
+            | quantize(pixel[0], 4) << 4 | quantize(pixel[3], 4));
+        std::memcpy(out.data() + 2 * i, &packed, sizeof(packed));
+    }
+}
+
+//! The largest difference between the channels of two BGRA pixels, or -1
+//! if both are invisible.
+int get_difference(const unsigned char* first,
+                   const unsigned char* second) noexcept
+{
+    if (first[3] == 0 && second[3] == 0) {
+        return -1;
+    }
+
+    int largest = 0;
+    for (std::size_t c = 0; c < 4; ++c) {
+        largest = std::max(largest, std::abs(first[c] - second[c]));
+    }
+
+    return largest;
+}
+
+//! Encode the alpha of a block: two endpoints and eight interpolated
+//! values, with a 3-bit index per pixel.
+void encode_alpha(const std::array<unsigned char, 64>& block,
+                  unsigned char* out)
+{
+    unsigned char max = 0;
+    unsigned char min = 255;
+    for (std::size_t i = 0; i < 16; ++i) {
+        max = std::max(max, block[4 * i + 3]);
+        min = std::min(min, block[4 * i + 3]);
+    }
+
+    out[0] = max;
+    out[1] = min;
+
+    std::uint64_t indices = 0;
+    if (max > min) {
+        for (std::size_t i = 0; i < 16; ++i) {
+            // Steps from the first endpoint, which are stored as 0 for the
+            // first, 1 for the last and 2 to 7 in between.
+            std::int32_t range = max - min;
+            std::int32_t step
+                = ((max - block[4 * i + 3]) * 7 + range / 2) / range;
+            std::uint64_t index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+            indices |= index << (3 * i);
+        }
+    }
+
+    for (std::size_t i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+//! Encode the color of a block: the corners of its bounding box, inset a
+//! little, and two colors in between, with a 2-bit index per pixel.
+void encode_color(const std::array<unsigned char, 64>& block,
+                  unsigned char* out)
+{
+    // Invisible pixels can have any color.
+    std::array<std::int32_t, 3> max{0, 0, 0};
+    std::array<std::int32_t, 3> min{255, 255, 255};
+    bool visible = false;
+    for (std::size_t i = 0; i < 16; ++i) {
+        if (block[4 * i + 3] == 0) {
+            continue;
+        }
+
+        visible = true;
+        for (std::size_t c = 0; c < 3; ++c) {
+            // The block holds BGRA, the endpoints RGB.
+            std::int32_t value = block[4 * i + 2 - c];
+            max[c] = std::max(max[c], value);
+            min[c] = std::min(min[c], value);
+        }
+    }
+
+    if (!visible) {
+        std::memset(out, 0, 8);
+        return;
+    }
+
+    for (std::size_t c = 0; c < 3; ++c) {
+        std::int32_t inset = (max[c] - min[c]) / 16;
+        max[c] -= inset;
+        min[c] += inset;
+    }
+
+    std::uint16_t color0 = to_rgb565(max);
+    std::uint16_t color1 = to_rgb565(min);
+
+    std::array<std::array<std::int32_t, 3>, 4> palette;
+    palette[0] = from_rgb565(color0);
+    palette[1] = from_rgb565(color1);
+    for (std::size_t c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    std::uint32_t indices = 0;
+    if (color0 != color1) {
+        for (std::size_t i = 0; i < 16; ++i) {
+            std::uint32_t best = 0;
+            std::int32_t best_distance = -1;
+            for (std::uint32_t p = 0; p < 4; ++p) {
+                std::int32_t distance = 0;
+                for (std::size_t c = 0; c < 3; ++c) {
+                    std::int32_t delta = block[4 * i + 2 - c] - palette[p][c];
+                    distance += delta * delta;
+                }
+
+                if (best_distance < 0 || distance < best_distance) {
+                    best = p;
+                    best_distance = distance;
+                }
+            }
+
+            indices |= best << (2 * i);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(color0);
+    out[1] = static_cast<unsigned char>(color0 >> 8);
+    out[2] = static_cast<unsigned char>(color1);
+    out[3] = static_cast<unsigned char>(color1 >> 8);
+    for (std::size_t i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+void encode_bc3(const unsigned char* bgra,
+                GLshort w,
+                GLshort h,
+                std::vector<unsigned char>& out)
+{
+    GLshort blocks_x = align(AtlasFormat::BC3, w) / BLOCK_SIZE;
+    GLshort blocks_y = align(AtlasFormat::BC3, h) / BLOCK_SIZE;
+    out.resize(16 * static_cast<std::size_t>(blocks_x) * blocks_y);
+
+    std::array<unsigned char, 64> block;
+    unsigned char* next = out.data();
+    for (GLshort by = 0; by < blocks_y; ++by) {
+        for (GLshort bx = 0; bx < blocks_x; ++bx) {
+            for (GLshort y = 0; y < BLOCK_SIZE; ++y) {
+                GLshort row = std::min<GLshort>(by * BLOCK_SIZE + y, h - 1);
+                for (GLshort x = 0; x < BLOCK_SIZE; ++x) {
+                    GLshort column
+                        = std::min<GLshort>(bx * BLOCK_SIZE + x, w - 1);
+                    std::memcpy(block.data() + 4 * (BLOCK_SIZE * y + x),
+                                bgra + 4 * (row * w + column),
+                                4);
+                }
+            }
+
+            encode_alpha(block, next);
+            encode_color(block, next + 8);
+            next += 16;
+        }
+    }
+}
+} // namespace
+
+GLshort align(AtlasFormat format, GLshort size) noexcept
+{
+    if (format == AtlasFormat::BC3) {
+        return (size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    }
+
+    return size;
+}
+
+std::size_t get_size(AtlasFormat format, GLshort w, GLshort h) noexcept
+{
+    auto pixels = static_cast<std::size_t>(align(format, w))
+                  * static_cast<std::size_t>(align(format, h));
+    switch (format) {
+    case AtlasFormat::RGBA4:
+        return 2 * pixels;
+    case AtlasFormat::BC3:
+        return pixels;
+    default:
+        return 4 * pixels;
+    }
+}
+
+GLenum get_upload_format(AtlasFormat format) noexcept
+{
+    switch (format) {
+    case AtlasFormat::RGBA4:
+        return GL_RGBA;
+    case AtlasFormat::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    default:
+        return GL_BGRA;
+    }
+}
+
+GLenum get_upload_type(AtlasFormat format) noexcept
+{
+    return format == AtlasFormat::RGBA4 ? GL_UNSIGNED_SHORT_4_4_4_4
+                                        : GL_UNSIGNED_BYTE;
+}
+
+GLenum get_internal_format(AtlasFormat format) noexcept
+{
+    switch (format) {
+    case AtlasFormat::RGBA4:
+        return GL_RGBA4;
+    case AtlasFormat::BC3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    default:
+        return GL_RGBA;
+    }
+}
+
+bool has_gradients(const unsigned char* bgra, GLshort w, GLshort h) noexcept
+{
+    // Flat colours and hard edges change by a lot between neighbours, or
+    // not at all. Ramps change by less than a step of 4 bits, many times
+    // over, and rounding them to 4 bits leaves a few large steps instead.
+    std::size_t changes = 0;
+    std::size_t small_changes = 0;
+    auto compare = [&](const unsigned char* first,
+                       const unsigned char* second) {
+        int difference = get_difference(first, second);
+        if (difference > 0) {
+            ++changes;
+            if (difference < RGBA4_STEP) {
+                ++small_changes;
+            }
+        }
+    };
+
+    auto stride = 4 * static_cast<std::size_t>(w);
+    for (GLshort y = 0; y < h; ++y) {
+        const unsigned char* row = bgra + y * stride;
+        for (GLshort x = 0; x < w; ++x) {
+            const unsigned char* pixel = row + 4 * x;
+            if (x > 0) {
+                compare(pixel - 4, pixel);
+            }
+
+            if (y > 0) {
+                compare(pixel - stride, pixel);
+            }
+        }
+    }
+
+    // Shading and antialiasing make some small changes in most sprites.
+    return 2 * small_changes > changes;
+}
+
+void encode(AtlasFormat format,
+            const unsigned char* bgra,
+            GLshort w,
+            GLshort h,
+            std::vector<unsigned char>& out)
+{
+    auto count = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+    switch (format) {
+    case AtlasFormat::RGBA4:
+        encode_rgba4(bgra, count, out);
+        break;
+    case AtlasFormat::BC3:
+        encode_bc3(bgra, w, h, out);
+        break;
+    default:
+        out.assign(bgra, bgra + 4 * count);
+        break;
+    }
+}
+} // namespace texture_encoding
+} // namespace jrc
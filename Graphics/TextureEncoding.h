@@ -0,0 +1,62 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "GL/glew.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace jrc
+{
+//! Formats the sprite atlas can be stored in.
+enum class AtlasFormat : std::uint8_t {
+    //! 32 bits per pixel.
+    RGBA8,
+    //! 16 bits per pixel, for sprites without fine gradients.
+    RGBA4,
+    //! BC3 (DXT5) blocks of 4x4 pixels, 8 bits per pixel.
+    BC3
+};
+
+namespace texture_encoding
+{
+//! The size of bitmaps in the atlas, which is a multiple of the block size
+//! for block compressed formats.
+GLshort align(AtlasFormat format, GLshort size) noexcept;
+//! The bytes needed for a bitmap of `w` by `h` pixels, after aligning.
+std::size_t get_size(AtlasFormat format, GLshort w, GLshort h) noexcept;
+//! The pixel format and type to upload encoded bitmaps with. The type is
+//! not used for compressed formats.
+GLenum get_upload_format(AtlasFormat format) noexcept;
+GLenum get_upload_type(AtlasFormat format) noexcept;
+//! The internal format of the atlas texture.
+GLenum get_internal_format(AtlasFormat format) noexcept;
+
+//! Whether `w` by `h` BGRA pixels have smooth ramps of colour or alpha,
+//! which would turn into visible bands with 4 bits per channel.
+bool has_gradients(const unsigned char* bgra, GLshort w, GLshort h) noexcept;
+
+//! Encode `w` by `h` BGRA pixels into `out`. Block compressed bitmaps are
+//! padded by repeating their last row and column.
+void encode(AtlasFormat format,
+            const unsigned char* bgra,
+            GLshort w,
+            GLshort h,
+            std::vector<unsigned char>& out);
+} // namespace texture_encoding
+} // namespace jrc
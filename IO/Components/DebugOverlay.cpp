@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "DebugOverlay.h"
+
+#include "../../Configuration.h"
+#include "../../Constants.h"
+#include "../../Graphics/GraphicsGL.h"
+#include "../../Graphics/TextLayoutCache.h"
+#include "../../Util/FrameScheduler.h"
+#include "../../Util/Profiler.h"
+
+#include <cstdio>
+
+namespace jrc
+{
+DebugOverlay::DebugOverlay()
+    : background{230, NUM_LINES * LINE_HEIGHT + 4, ColorBox::BLACK, 0.6f},
+      refresh_countdown{0},
+      active{Configuration::get().performance.debug_overlay}
+{
+    for (Text& line : lines) {
+        line = Text(Text::A11M, Text::LEFT, Text::WHITE);
+    }
+}
+
+void DebugOverlay::toggle() noexcept
+{
+    active = !active;
+    refresh_countdown = 0;
+}
+
+void DebugOverlay::draw() const
+{
+    if (!active) {
+        return;
+    }
+
+    Point<std::int16_t> position{4, 24 - Constants::VIEW_Y_OFFSET};
+    background.draw(position);
+
+    for (const Text& line : lines) {
+        line.draw(position + Point<std::int16_t>{4, 0});
+        position.shift_y(LINE_HEIGHT);
+    }
+}
+
+void DebugOverlay::update()
+{
+    if (!active || refresh_countdown-- > 0) {
+        return;
+    }
+
+    refresh_countdown = REFRESH_INTERVAL;
+
+    const FrameScheduler::Stats& stats = FrameScheduler::get().get_stats();
+    char buffer[96];
+
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "FPS %.1f  frame %.2f ms, worst %.2f ms",
+                  stats.fps,
+                  stats.frame_ms,
+                  stats.worst_frame_ms);
+    lines[0].change_text(buffer);
+
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "late frames %u  dropped updates %u",
+                  stats.late_frames,
+                  stats.dropped_steps);
+    lines[1].change_text(buffer);
+
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "input latency %.1f ms, worst %.1f ms",
+                  stats.latency_ms,
+                  stats.worst_latency_ms);
+    lines[2].change_text(buffer);
+
+    auto layouts = TextLayoutCache::get().get_stats();
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "text layouts %zu, %.1f%% hits",
+                  layouts.entries,
+                  layouts.hit_rate() * 100.0f);
+    lines[3].change_text(buffer);
+
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "draw calls %u",
+                  GraphicsGL::get().get_draw_calls());
+    lines[4].change_text(buffer);
+
+#ifdef JOURNEY_PROFILE
+    auto update_stats = Profiler::get().get_stats("update");
+    auto draw_stats = Profiler::get().get_stats("draw");
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "p95 update %.2f ms  draw %.2f ms",
+                  update_stats.p95 / 1'000.0,
+                  draw_stats.p95 / 1'000.0);
+    lines[5].change_text(buffer);
+#endif
+}
+} // namespace jrc
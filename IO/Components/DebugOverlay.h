@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../../Graphics/Geometry.h"
+#include "../../Graphics/Text.h"
+
+#include <array>
+
+namespace jrc
+{
+//! Frame timing stats in the top left corner of the screen, on top of every
+//! UI state.
+class DebugOverlay
+{
+public:
+    DebugOverlay();
+
+    void toggle() noexcept;
+    void draw() const;
+    void update();
+
+private:
+    static constexpr std::size_t NUM_LINES = 6;
+    static constexpr std::int16_t LINE_HEIGHT = 14;
+    //! Number of updates between refreshes of the text, about a quarter of a
+    //! second.
+    static constexpr std::uint16_t REFRESH_INTERVAL = 32;
+
+    ColorBox background;
+    std::array<Text, NUM_LINES> lines;
+    std::uint16_t refresh_countdown;
+    bool active;
+};
+} // namespace jrc
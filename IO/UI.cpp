@@ -18,6 +18,7 @@
 #include "UI.h"
 
 #include "../Graphics/GraphicsGL.h"
+#include "../Util/Profiler.h"
 #include "UIStateGame.h"
 #include "UIStateLogin.h"
 #include "UITypes/UIChangeChannel.h"
@@ -37,17 +38,23 @@ void UI::init()
 
 void UI::draw(float alpha) const
 {
+    GraphicsGL::get().set_layer(SpriteBatcher::INTERFACE);
+
     state->draw(alpha, cursor.get_position());
 
     scrolling_notice.draw(alpha);
+    debug_overlay.draw();
     cursor.draw(alpha);
 }
 
 void UI::update()
 {
+    JOURNEY_ZONE("UI::update");
+
     state->update();
 
     scrolling_notice.update();
+    debug_overlay.update();
     cursor.update();
 }
 
@@ -128,6 +135,13 @@ void UI::send_key(std::int32_t keycode, bool pressed)
 {
     keycode = Keyboard::align_key_parity(keycode);
 
+    if (keycode == GLFW_KEY_F12) {
+        if (pressed) {
+            debug_overlay.toggle();
+        }
+        return;
+    }
+
     if (focused_text_field) {
         bool ctrl = is_key_down[keyboard.ctrl_code()];
         if (ctrl) {
@@ -20,8 +20,13 @@
 #include "../Configuration.h"
 #include "../Console.h"
 #include "../Constants.h"
+#include "../Graphics/GLBackend.h"
 #include "../Graphics/GraphicsGL.h"
+#include "../Graphics/NullBackend.h"
+#include "../Graphics/OffscreenBackend.h"
+#include "../Util/FrameScheduler.h"
 #include "../Util/Misc.h"
+#include "../Util/Profiler.h"
 #include "UI.h"
 
 #include <string_view>
@@ -34,7 +39,8 @@ Window::Window()
       opacity{1.0f},
       opcstep{0.0f},
       width{Constants::VIEW_WIDTH},
-      height{Constants::VIEW_HEIGHT}
+      height{Constants::VIEW_HEIGHT},
+      headless{false}
 {
 }
 
@@ -47,6 +53,17 @@ Error Window::init()
 {
     full_screen = Configuration::get().video.fullscreen;
 
+    if (auto backend = create_headless_backend()) {
+        headless = true;
+        if (Error error = GraphicsGL::get().init(std::move(backend))) {
+            return error;
+        }
+
+        GraphicsGL::get().reinit();
+
+        return Error::NONE;
+    }
+
     if (!glfwInit()) {
         return Error::GLFW;
     }
@@ -64,13 +81,37 @@ Error Window::init()
     glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
     glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
 
-    if (Error error = GraphicsGL::get().init()) {
+    if (Error error = GraphicsGL::get().init(std::make_unique<GLBackend>())) {
         return error;
     }
 
     return init_window();
 }
 
+std::unique_ptr<RenderBackend> Window::create_headless_backend() const
+{
+    const std::string& backend = Configuration::get().video.backend;
+    if (backend == "null") {
+        return std::make_unique<NullBackend>();
+    } else if (backend == "offscreen") {
+#ifdef JOURNEY_USE_OSMESA
+        return std::make_unique<OffscreenBackend>();
+#else
+        Console::get().print("[Warning] The client was built without "
+                             "JOURNEY_USE_OSMESA, so it cannot render "
+                             "offscreen; using a window instead.");
+#endif
+    } else if (backend != "window") {
+        Console::get().print(
+            str::concat("[Warning] Unknown value \"",
+                        std::string_view{backend},
+                        "\" for \"settings.toml:video.backend\"; using a "
+                        "window instead."));
+    }
+
+    return nullptr;
+}
+
 Error Window::init_window()
 {
     if (glwnd) {
@@ -98,6 +139,7 @@ Error Window::init_window()
     glfwSetInputMode(glwnd, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
     // glfwSetInputMode(glwnd, GLFW_STICKY_KEYS, 1);
     glfwSetKeyCallback(glwnd, [](GLFWwindow*, int key, int, int action, int) {
+        FrameScheduler::get().on_input();
         UI::get().send_key(key, action != GLFW_RELEASE);
     });
     glfwSetMouseButtonCallback(glwnd,
@@ -140,7 +182,7 @@ Error Window::init_window()
 
 bool Window::not_closed() const
 {
-    return glfwWindowShouldClose(glwnd) == 0;
+    return headless || glfwWindowShouldClose(glwnd) == 0;
 }
 
 void Window::update()
@@ -167,23 +209,62 @@ void Window::update_opc()
 
 void Window::check_events()
 {
+    if (headless) {
+        return;
+    }
+
     std::int32_t tabstate = glfwGetKey(glwnd, GLFW_KEY_F11);
     if (tabstate == GLFW_PRESS) {
         full_screen = !full_screen;
+
+        // The old window is destroyed along with the context that the render
+        // thread would be using.
+        bool threaded = GraphicsGL::get().is_render_thread_running();
+        stop_render_thread();
         init_window();
+        if (threaded) {
+            start_render_thread();
+        }
     }
     glfwPollEvents();
 }
 
 void Window::begin() const
 {
+    GraphicsGL::get().add_rasterized_glyphs();
+    GraphicsGL::get().add_decoded_bitmaps();
     GraphicsGL::get().clearscene();
 }
 
 void Window::end() const
 {
-    GraphicsGL::get().flush(opacity);
-    glfwSwapBuffers(glwnd);
+    GraphicsGL& graphics = GraphicsGL::get();
+    graphics.flush(opacity);
+    FrameScheduler::get().on_flush();
+
+    if (headless) {
+        graphics.get_backend().present();
+        FrameScheduler::get().on_present();
+    } else if (!graphics.is_render_thread_running()) {
+        JOURNEY_ZONE("glfwSwapBuffers");
+        glfwSwapBuffers(glwnd);
+        FrameScheduler::get().on_present();
+    }
+}
+
+void Window::start_render_thread() const
+{
+    // Without a window, there is no context to move to another thread.
+    if (headless) {
+        return;
+    }
+
+    GraphicsGL::get().start_render_thread(glwnd);
+}
+
+void Window::stop_render_thread() const
+{
+    GraphicsGL::get().stop_render_thread();
 }
 
 void Window::fadeout(float step, std::function<void()> fade_proc)
@@ -194,15 +275,21 @@ void Window::fadeout(float step, std::function<void()> fade_proc)
 
 void Window::set_clipboard(const char* text) const
 {
-    glfwSetClipboardString(glwnd, text);
+    if (!headless) {
+        glfwSetClipboardString(glwnd, text);
+    }
 }
 void Window::set_clipboard(const std::string& text) const
 {
-    glfwSetClipboardString(glwnd, text.c_str());
+    set_clipboard(text.c_str());
 }
 
 const char* Window::get_clipboard() const
 {
+    if (headless) {
+        return "";
+    }
+
     const char* text = glfwGetClipboardString(glwnd);
     return text ? text : "";
 }
@@ -217,8 +304,9 @@ void Window::resize(bool in_game) noexcept
         height = Constants::VIEW_HEIGHT;
     }
 
-    glfwSetWindowSize(glwnd, width, height);
-    glViewport(0, 0, width, height);
+    if (!headless) {
+        glfwSetWindowSize(glwnd, width, height);
+    }
     GraphicsGL::set_screen(0,
                            width,
                            -Constants::VIEW_Y_OFFSET,
@@ -17,11 +17,13 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "../Error.h"
+#include "../Graphics/RenderBackend.h"
 #include "../Template/Singleton.h"
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace jrc
@@ -41,6 +43,9 @@ public:
     void end() const;
     void fadeout(float step, std::function<void()> fade_proc);
     void check_events();
+    //! Draw and swap frames on a separate thread. See `GraphicsGL`.
+    void start_render_thread() const;
+    void stop_render_thread() const;
 
     void set_clipboard(const char* text) const;
     void set_clipboard(const std::string& text) const;
@@ -52,6 +57,9 @@ public:
 
 private:
     void update_opc();
+    //! Create the backend chosen in the settings, or nothing if frames are
+    //! drawn to a window.
+    std::unique_ptr<RenderBackend> create_headless_backend() const;
 
     GLFWwindow* glwnd;
     GLFWwindow* context;
@@ -62,5 +70,6 @@ private:
 
     std::int16_t width;
     std::int16_t height;
+    bool headless;
 };
 } // namespace jrc
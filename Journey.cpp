@@ -17,69 +17,103 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "Audio/Audio.h"
 #include "Character/Char.h"
+#include "Character/Look/CharLook.h"
 #include "Configuration.h"
 #include "Constants.h"
 #include "Error.h"
 #include "Gameplay/Combat/DamageNumber.h"
 #include "Gameplay/Stage.h"
+#include "Graphics/GraphicsGL.h"
 #include "IO/UI.h"
 #include "IO/Window.h"
 #include "Net/Session.h"
 #include "Timer.h"
+#include "Util/FrameScheduler.h"
+#include "Util/HashUtility.h"
 #include "Util/NxFiles.h"
+#include "Util/Profiler.h"
+#include "Util/TaskGraph.h"
 
 #include <iostream>
 #include <locale>
 
 namespace jrc
 {
-Error init()
+Error init(TaskGraph& startup)
 {
-    if (Error error = Session::get().init(); error) {
-        return error;
-    }
-
-    if (Error error = NxFiles::init(); error) {
-        return error;
-    }
-
-    if (Error error = Window::get().init(); error) {
-        return error;
-    }
-
-    if (Configuration::get().audio.sound_effects
-        || Configuration::get().audio.music) {
-        if (Error error = Sound::init(); error) {
-            return error;
+    auto network = startup.add("network", TaskGraph::WORKER, {}, [] {
+        return Session::get().init();
+    });
+    auto nx = startup.add("nx", TaskGraph::WORKER, {}, [] {
+        return NxFiles::init();
+    });
+    auto fonts = startup.add("fonts", TaskGraph::WORKER, {}, [] {
+        return GraphicsGL::get().init_fonts();
+    });
+    auto window = startup.add("window", TaskGraph::MAIN, {fonts}, [] {
+        return Window::get().init();
+    });
+    auto audio = startup.add("audio", TaskGraph::WORKER, {nx}, []() -> Error {
+        if (Configuration::get().audio.sound_effects
+            || Configuration::get().audio.music) {
+            if (Error error = Sound::init(); error) {
+                return error;
+            }
         }
-    }
 
-    if (Configuration::get().audio.sound_effects) {
-        Sound::init_sfx();
-    }
-    if (Configuration::get().audio.music) {
-        Music::init();
-    }
-    Char::init();
-    DamageNumber::init();
-    MapPortals::init();
-    Stage::get().init();
-    UI::get().init();
+        if (Configuration::get().audio.sound_effects) {
+            Sound::init_sfx();
+        }
+        if (Configuration::get().audio.music) {
+            Music::init();
+        }
 
-    return Error::NONE;
+        return Error::NONE;
+    });
+    auto body = startup.add("body", TaskGraph::WORKER, {nx}, []() -> Error {
+        CharLook::init();
+        return Error::NONE;
+    });
+    startup.add("ui",
+                TaskGraph::MAIN,
+                {network, nx, window, audio, body},
+                []() -> Error {
+                    UI::get().init();
+                    return Error::NONE;
+                });
+
+    // Nothing below is needed to show the login screen, so it is spread
+    // over the first frames instead.
+    auto deferred = [&](const char* name, void (*init)()) {
+        startup.add(name, TaskGraph::DEFERRED, {nx, window}, [init] {
+            init();
+            return Error(Error::NONE);
+        });
+    };
+    deferred("char_effects", Char::init);
+    deferred("damage_numbers", DamageNumber::init);
+    deferred("portals", MapPortals::init);
+    deferred("stage", [] { Stage::get().init(); });
+
+    return startup.run();
 }
 
 void update()
 {
+    JOURNEY_ZONE("update");
+
     Window::get().check_events();
     Window::get().update();
     Stage::get().update();
     UI::get().update();
+    Music::update();
     Session::get().read();
 }
 
 void draw(float alpha)
 {
+    JOURNEY_ZONE("draw");
+
     Window::get().begin();
     Stage::get().draw(alpha);
     UI::get().draw(alpha);
@@ -92,41 +126,54 @@ bool running()
            && Window::get().not_closed();
 }
 
-void loop()
+void loop(TaskGraph& startup)
 {
-    Timer::get().start();
-    std::int64_t timestep = Constants::TIMESTEP * 1'000;
-    std::int64_t accumulator = timestep;
+    const auto& performance = Configuration::get().performance;
+    FrameScheduler& scheduler = FrameScheduler::get();
+    scheduler.init(performance.max_fps, performance.max_update_steps);
+
+    if (performance.render_thread) {
+        Window::get().start_render_thread();
+    }
+
+    std::uint32_t frames_left = performance.benchmark_frames;
+    if (frames_left > 0) {
+        scheduler.run_fixed();
+    }
 
-    std::int64_t period = 0;
-    std::int32_t samples = 0;
+    Timer::get().start();
 
     while (running()) {
-        std::int64_t elapsed = Timer::get().stop();
+        JOURNEY_ZONE("frame");
+
+        // Finish the deferred startup work one stage per frame.
+        startup.run_deferred();
 
-        // Update game with constant timestep as many times as possible.
-        for (accumulator += elapsed; accumulator >= timestep;
-             accumulator -= timestep) {
+        // Wait for the frame-rate cap, then update the game with a constant
+        // timestep as many times as the elapsed time allows.
+        for (std::int32_t steps = scheduler.begin_frame(); steps > 0;
+             --steps) {
             update();
         }
 
         // Draw the game. Interpolate to account for remaining time.
-        float alpha = static_cast<float>(accumulator) / timestep;
-        draw(alpha);
-
-        if (samples < 100) {
-            period += elapsed;
-            ++samples;
-        } else if (period) {
-            // std::int64_t fps = (samples * 1000000) / period;
-            // std::cout << "FPS: " << fps << '\n';
-
-            period = 0;
-            samples = 0;
+        draw(scheduler.get_alpha());
+
+#ifdef JOURNEY_PROFILE
+        Profiler::get().collect();
+#endif
+
+        if (frames_left > 0 && --frames_left == 0) {
+            break;
         }
     }
 
+    Window::get().stop_render_thread();
+    GraphicsGL::get().close();
     Sound::close();
+#ifdef JOURNEY_USE_XXHASH
+    HashUtility::shutdown();
+#endif
 }
 
 void start()
@@ -135,8 +182,10 @@ void start()
     // reasons.
     std::ios::sync_with_stdio(false);
 
+    TaskGraph startup;
+
     // Initialize and check for errors.
-    if (Error error = init()) {
+    if (Error error = init(startup)) {
         const char* message = error.get_message();
         const char* args = error.get_args();
         const bool can_retry = error.can_retry();
@@ -150,7 +199,17 @@ void start()
             start();
         }
     } else {
-        loop();
+        loop(startup);
+        startup.print_timings(std::cout);
+        GraphicsGL::get().get_backend().report(std::cout);
+
+#ifdef JOURNEY_PROFILE
+        Profiler::get().collect();
+        Profiler::get().print_stats(std::cout);
+        if (!Profiler::get().write_trace("trace.json")) {
+            std::cout << "Could not write \"trace.json\".\n";
+        }
+#endif
     }
 }
 } // namespace jrc
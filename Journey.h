@@ -29,3 +29,11 @@
 
 //! JOURNEY_PRINT_WARNINGS : Print warnings and minor errors to the console.
 #define JOURNEY_PRINT_WARNINGS
+
+//! JOURNEY_USE_OSMESA : Allow rendering without a display through OSMesa, with
+//! `video.backend = "offscreen"` (additional dependency)
+//#define JOURNEY_USE_OSMESA
+
+//! JOURNEY_PROFILE : Time frames and subsystems, print their percentiles on
+//! exit and write them to "trace.json".
+//#define JOURNEY_PROFILE
@@ -17,6 +17,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "CustomHandlers.h"
 
+#include "../../Configuration.h"
 #include "../Packets/CustomPackets.h"
 
 namespace jrc
@@ -26,6 +27,9 @@ void NxCheckRequestHandler::handle(InPacket& recv) const
 {
     std::uint64_t seed = recv.read_long();
     NxCheckPacket(seed).dispatch();
+
+    // Remember the seed, so the next session can hash the files up front.
+    Configuration::get().network.hash_seed = seed;
 }
 #endif
 } // namespace jrc
@@ -18,6 +18,7 @@
 #include "PacketSwitch.h"
 
 #include "../Console.h"
+#include "../Util/Profiler.h"
 #include "Handlers/AttackHandlers.h"
 #include "Handlers/CommonHandlers.h"
 #include "Handlers/InventoryHandlers.h"
@@ -228,6 +229,8 @@ PacketSwitch::PacketSwitch()
 
 void PacketSwitch::forward(const std::int8_t* bytes, std::size_t length) const
 {
+    JOURNEY_ZONE("PacketSwitch::forward");
+
     // Wrap the bytes with a parser.
     InPacket recv{bytes, length};
     // Read the opcode to determine handler responsible.
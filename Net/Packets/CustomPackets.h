@@ -33,9 +33,15 @@ class NxCheckPacket : public OutPacket
 public:
     NxCheckPacket(std::uint64_t seed) : OutPacket(HASH_CHECK)
     {
+        // Hash all files in parallel. Usually they were already hashed in
+        // the background with the same seed during startup.
+        for (auto filename : NxFiles::filenames) {
+            HashUtility::prefetch_filehash(filename, seed);
+        }
+
         write_byte(NxFiles::NUM_FILES);
         for (auto filename : NxFiles::filenames) {
-            write_string(HashUtility::get_filehash(filename, seed));
+            write_string(HashUtility::get_filehash_string(filename, seed));
         }
     }
 };
@@ -20,6 +20,7 @@
 
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace jrc
 {
@@ -66,6 +67,16 @@ public:
         write_byte(1);
         writemovement(movement);
     }
+
+    MovePlayerPacket(const std::vector<Movement>& movements)
+        : MovementPacket(MOVE_PLAYER)
+    {
+        skip(9);
+        write_byte(static_cast<std::int8_t>(movements.size()));
+        for (const Movement& movement : movements) {
+            writemovement(movement);
+        }
+    }
 };
 
 //! Requests one or more new keybindings to be registered.
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace jrc
+{
+//! Up to `N` objects stored in place, so that adding and removing them
+//! never allocates. Once it is full, adding an object drops the first one.
+template<typename T, std::size_t N>
+class FixedPool
+{
+public:
+    FixedPool() noexcept : count{0}
+    {
+    }
+
+    //! Add an object at the end.
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        return emplace(count, std::forward<Args>(args)...);
+    }
+
+    //! Add an object before the one at `index`.
+    template<typename... Args>
+    T& emplace(std::size_t index, Args&&... args)
+    {
+        if (count == N) {
+            std::move(items.begin() + 1, items.begin() + count, items.begin());
+            --count;
+            if (index > 0) {
+                --index;
+            }
+        }
+
+        std::move_backward(items.begin() + index,
+                           items.begin() + count,
+                           items.begin() + count + 1);
+        items[index] = T(std::forward<Args>(args)...);
+        ++count;
+
+        return items[index];
+    }
+
+    //! Remove the objects for which `predicate` returns true, keeping the
+    //! order of the others.
+    template<typename Predicate>
+    void remove_if(Predicate&& predicate)
+    {
+        T* last = std::remove_if(
+            begin(), end(), std::forward<Predicate>(predicate));
+        std::fill(last, end(), T{});
+        count = static_cast<std::size_t>(last - begin());
+    }
+
+    void clear()
+    {
+        std::fill(begin(), end(), T{});
+        count = 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    T* begin() noexcept
+    {
+        return items.data();
+    }
+
+    T* end() noexcept
+    {
+        return items.data() + count;
+    }
+
+    const T* begin() const noexcept
+    {
+        return items.data();
+    }
+
+    const T* end() const noexcept
+    {
+        return items.data() + count;
+    }
+
+private:
+    std::array<T, N> items;
+    std::size_t count;
+};
+} // namespace jrc
@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Point.h"
+#include "Rectangle.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace jrc
+{
+//! Values sorted into square cells by the area they cover, so that the
+//! ones which may cover a point are found without looking at the rest.
+template<typename T>
+class SpatialHash
+{
+public:
+    //! Add a value which covers the given area.
+    void insert(const Rectangle<std::int16_t>& area, T value)
+    {
+        std::int32_t left = cell_of(area.l());
+        std::int32_t right = cell_of(area.r());
+        std::int32_t top = cell_of(area.t());
+        std::int32_t bottom = cell_of(area.b());
+
+        for (std::int32_t y = top; y <= bottom; ++y) {
+            for (std::int32_t x = left; x <= right; ++x) {
+                cells[key(x, y)].push_back(value);
+            }
+        }
+    }
+
+    //! Return the values whose area may cover the position, in the order
+    //! they were added.
+    const std::vector<T>& at(Point<std::int16_t> position) const
+    {
+        auto iter
+            = cells.find(key(cell_of(position.x()), cell_of(position.y())));
+        return iter != cells.end() ? iter->second : none;
+    }
+
+    //! Remove all values, but keep the cells allocated for refilling.
+    void clear()
+    {
+        for (auto& cell : cells) {
+            cell.second.clear();
+        }
+    }
+
+private:
+    //! Width and height of a cell in pixels, as a power of two.
+    static constexpr std::int32_t CELL_SHIFT = 7;
+
+    static std::int32_t cell_of(std::int16_t coordinate)
+    {
+        // The shift rounds towards negative infinity.
+        return coordinate >> CELL_SHIFT;
+    }
+
+    static std::uint32_t key(std::int32_t x, std::int32_t y)
+    {
+        return (static_cast<std::uint32_t>(x) << 16)
+               | (static_cast<std::uint32_t>(y) & 0xFFFF);
+    }
+
+    std::unordered_map<std::uint32_t, std::vector<T>> cells;
+
+    static inline const std::vector<T> none;
+};
+} // namespace jrc
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Rectangle.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace jrc
+{
+//! Values sorted by the left edge of the area they cover, so that the ones
+//! overlapping a range are found without looking at the rest.
+//!
+//! The areas are refreshed all at once, and the order is restored with an
+//! insertion sort. That takes linear time when few values have passed each
+//! other since the last refresh, as is the case for things moving around a
+//! map.
+template<typename T>
+class SweepList
+{
+public:
+    //! Add a value, which covers nothing until the next refresh.
+    void add(T value)
+    {
+        entries.push_back({{}, std::move(value)});
+    }
+
+    //! Ask `bounds_of(value, bounds)` for the area each value covers now.
+    //! Values for which it returns false are removed.
+    template<typename Bounds>
+    void refresh(Bounds&& bounds_of)
+    {
+        widest = 0;
+        auto removed = std::remove_if(
+            entries.begin(), entries.end(), [&](Entry& entry) {
+                if (!bounds_of(entry.value, entry.bounds)) {
+                    return true;
+                }
+
+                widest = std::max(widest, entry.bounds.width());
+                return false;
+            });
+        entries.erase(removed, entries.end());
+
+        for (std::size_t i = 1; i < entries.size(); ++i) {
+            Entry entry = std::move(entries[i]);
+            std::size_t j = i;
+            for (; j > 0 && entries[j - 1].bounds.l() > entry.bounds.l();
+                 --j) {
+                entries[j] = std::move(entries[j - 1]);
+            }
+
+            entries[j] = std::move(entry);
+        }
+    }
+
+    //! Call `visit(value)` with every value whose area overlaps the range,
+    //! from left to right, until it returns false.
+    template<typename Visitor>
+    void visit(const Rectangle<std::int16_t>& range, Visitor&& visit) const
+    {
+        // The widest area starts furthest to the left of the range.
+        auto first = std::lower_bound(
+            entries.begin(),
+            entries.end(),
+            range.l() - widest,
+            [](const Entry& entry, int x) { return entry.bounds.l() < x; });
+
+        for (auto iter = first;
+             iter != entries.end() && iter->bounds.l() <= range.r();
+             ++iter) {
+            if (range.overlaps(iter->bounds) && !visit(iter->value)) {
+                return;
+            }
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+        widest = 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return entries.size();
+    }
+
+private:
+    struct Entry {
+        Rectangle<std::int16_t> bounds;
+        T value;
+    };
+
+    std::vector<Entry> entries;
+    std::int16_t widest = 0;
+};
+} // namespace jrc
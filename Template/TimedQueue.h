@@ -18,71 +18,273 @@
 #pragma once
 #include "../Constants.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <deque>
 #include <functional>
-#include <queue>
+#include <new>
+#include <utility>
 
 namespace jrc
 {
+//! Calls an action with each value once its delay has passed.
+//!
+//! Values are kept in a hierarchical timer wheel which advances in steps of
+//! `Constants::TIMESTEP` milliseconds, so that adding, cancelling and
+//! expiring a value takes constant time. The first wheel has a slot for
+//! each of the next 256 steps, and each further wheel holds 64 times as
+//! many steps per slot, which are moved down a wheel once they come
+//! closer. Values are constructed in place in pooled nodes, which are
+//! never moved.
 template<typename T>
 class TimedQueue
 {
 public:
+    //! Identifies a value which was added, for cancelling it.
+    struct Handle {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
     TimedQueue(std::function<void(const T&)> in_action)
-        : action(in_action), time(0)
+        : action(in_action), time(0), step(0), free_node(NONE), pending(0)
     {
+        slots.fill({NONE, NONE});
     }
 
-    void push(std::int64_t delay, const T& t)
+    TimedQueue(const TimedQueue&) = delete;
+    TimedQueue& operator=(const TimedQueue&) = delete;
+
+    ~TimedQueue()
     {
-        queue.emplace(time + delay, t);
+        for (Node& node : nodes) {
+            if (node.slot != FREE) {
+                node.get().~T();
+            }
+        }
+    }
+
+    Handle push(std::int64_t delay, const T& t)
+    {
+        return emplace(delay, t);
     }
 
     template<typename... Args>
-    void emplace(std::int64_t delay, Args&&... args)
+    Handle emplace(std::int64_t delay, Args&&... args)
     {
-        queue.emplace(time + delay, std::move(args)...);
+        std::uint32_t index = allocate();
+        Node& node = nodes[index];
+        new (node.storage) T{std::forward<Args>(args)...};
+
+        // Round up, so that no value is handled before its delay passed.
+        std::int64_t when = time + std::max<std::int64_t>(delay, 0);
+        node.due = std::max((when + STEP - 1) / STEP, step + 1);
+        insert(index);
+        ++pending;
+
+        return {index, node.generation};
+    }
+
+    //! Remove a value before it is handled. Returns false if it was handled
+    //! or cancelled already.
+    bool cancel(Handle handle)
+    {
+        if (handle.index >= nodes.size()) {
+            return false;
+        }
+
+        Node& node = nodes[handle.index];
+        if (node.generation != handle.generation || node.slot >= FIRING) {
+            return false;
+        }
+
+        unlink(handle.index);
+        release(handle.index);
+
+        return true;
+    }
+
+    bool empty() const noexcept
+    {
+        return pending == 0;
     }
 
     void update(std::int64_t timestep = Constants::TIMESTEP)
     {
         time += timestep;
 
-        for (; !queue.empty(); queue.pop()) {
-            const Timed& top = queue.top();
-            if (top.when > time) {
-                break;
-            }
+        std::int64_t target = time / STEP;
+        if (pending == 0) {
+            step = std::max(step, target);
+            return;
+        }
 
-            action(top.value);
+        while (step < target) {
+            advance();
         }
     }
 
 private:
-    struct Timed {
-        T value;
-        std::int64_t when;
+    static constexpr std::int64_t STEP = Constants::TIMESTEP;
+    static constexpr std::uint32_t NONE = UINT32_MAX;
 
-        Timed(std::int64_t w, const T& v) : value{v}, when{w}
-        {
-        }
+    static constexpr std::size_t WHEELS = 4;
+    static constexpr std::int64_t FIRST_BITS = 8;
+    static constexpr std::int64_t BITS = 6;
+    static constexpr std::size_t FIRST_SLOTS = 1 << FIRST_BITS;
+    static constexpr std::size_t SLOTS = 1 << BITS;
+    static constexpr std::size_t NUM_SLOTS
+        = FIRST_SLOTS + (WHEELS - 1) * SLOTS;
+    //! The steps covered by all wheels together.
+    static constexpr std::int64_t RANGE
+        = std::int64_t{1} << (FIRST_BITS + (WHEELS - 1) * BITS);
+
+    //! Values of `Node::slot` for nodes which are not in a slot.
+    static constexpr std::uint16_t FIRING = NUM_SLOTS;
+    static constexpr std::uint16_t FREE = NUM_SLOTS + 1;
 
-        template<typename... Args>
-        Timed(std::int64_t w, Args&&... args)
-            : value{std::forward<Args>(args)...}, when{w}
+    struct Node {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::int64_t due = 0;
+        std::uint32_t prev = NONE;
+        std::uint32_t next = NONE;
+        std::uint32_t generation = 0;
+        std::uint16_t slot = FREE;
+
+        T& get() noexcept
         {
+            return *std::launder(reinterpret_cast<T*>(storage));
         }
     };
 
-    struct TimedComparator {
-        bool operator()(const Timed& a, const Timed& b) const
-        {
-            return a.when > b.when;
-        }
+    struct Slot {
+        std::uint32_t head;
+        std::uint32_t tail;
     };
 
-    std::priority_queue<Timed, std::vector<Timed>, TimedComparator> queue;
+    std::uint32_t allocate()
+    {
+        if (free_node == NONE) {
+            nodes.emplace_back();
+            return static_cast<std::uint32_t>(nodes.size() - 1);
+        }
+
+        std::uint32_t index = free_node;
+        free_node = nodes[index].next;
+        return index;
+    }
+
+    void release(std::uint32_t index)
+    {
+        Node& node = nodes[index];
+        node.get().~T();
+        node.slot = FREE;
+        node.next = free_node;
+        ++node.generation;
+        free_node = index;
+        --pending;
+    }
+
+    //! Put the node into the slot for its step.
+    void insert(std::uint32_t index)
+    {
+        Node& node = nodes[index];
+        std::int64_t delta = std::min(node.due - step, RANGE - 1);
+        std::int64_t due = step + delta;
+
+        std::size_t slot;
+        if (delta < static_cast<std::int64_t>(FIRST_SLOTS)) {
+            slot = static_cast<std::size_t>(due) & (FIRST_SLOTS - 1);
+        } else {
+            std::size_t wheel = 1;
+            std::int64_t shift = FIRST_BITS;
+            while (delta >= std::int64_t{1} << (shift + BITS)) {
+                ++wheel;
+                shift += BITS;
+            }
+
+            slot = FIRST_SLOTS + (wheel - 1) * SLOTS
+                   + (static_cast<std::size_t>(due >> shift) & (SLOTS - 1));
+        }
+
+        Slot& list = slots[slot];
+        node.slot = static_cast<std::uint16_t>(slot);
+        node.prev = list.tail;
+        node.next = NONE;
+        if (list.tail == NONE) {
+            list.head = index;
+        } else {
+            nodes[list.tail].next = index;
+        }
+        list.tail = index;
+    }
+
+    void unlink(std::uint32_t index)
+    {
+        Node& node = nodes[index];
+        Slot& list = slots[node.slot];
+        if (node.prev == NONE) {
+            list.head = node.next;
+        } else {
+            nodes[node.prev].next = node.next;
+        }
+
+        if (node.next == NONE) {
+            list.tail = node.prev;
+        } else {
+            nodes[node.next].prev = node.prev;
+        }
+    }
+
+    //! Handle the values of the next step, after moving down those of the
+    //! outer wheels which come into range.
+    void advance()
+    {
+        ++step;
+
+        std::int64_t shift = FIRST_BITS;
+        for (std::size_t wheel = 1; wheel < WHEELS; ++wheel) {
+            if ((step & ((std::int64_t{1} << shift) - 1)) != 0) {
+                break;
+            }
+
+            std::size_t slot
+                = FIRST_SLOTS + (wheel - 1) * SLOTS
+                  + (static_cast<std::size_t>(step >> shift) & (SLOTS - 1));
+            std::uint32_t index = slots[slot].head;
+            slots[slot] = {NONE, NONE};
+            while (index != NONE) {
+                std::uint32_t next = nodes[index].next;
+                insert(index);
+                index = next;
+            }
+
+            shift += BITS;
+        }
+
+        // Nodes are taken off one at a time, so that the action can add and
+        // cancel values in the meantime. New values always go into a later
+        // slot.
+        Slot& list = slots[static_cast<std::size_t>(step) & (FIRST_SLOTS - 1)];
+        while (list.head != NONE) {
+            std::uint32_t index = list.head;
+            unlink(index);
+            nodes[index].slot = FIRING;
+            action(nodes[index].get());
+            release(index);
+        }
+    }
+
     std::function<void(const T&)> action;
     std::int64_t time;
+    //! The last step which was handled.
+    std::int64_t step;
+
+    //! Nodes stay at the same address when more are added.
+    std::deque<Node> nodes;
+    std::uint32_t free_node;
+    std::size_t pending;
+    std::array<Slot, NUM_SLOTS> slots;
 };
 } // namespace jrc
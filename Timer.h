@@ -49,6 +49,15 @@ public:
         return duration.count();
     }
 
+    //! Return time elapsed since the last measurement, without taking a new
+    //! one.
+    std::int64_t peek() const noexcept
+    {
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            clock::now() - point);
+        return duration.count();
+    }
+
 private:
     using clock = std::chrono::high_resolution_clock;
 
@@ -0,0 +1,274 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "BitmapCache.h"
+
+#ifdef JOURNEY_USE_XXHASH
+#    include "../Configuration.h"
+#    include "../Console.h"
+
+#    include <cstring>
+#    include <fstream>
+#    include <xxhash.h>
+
+namespace jrc
+{
+namespace
+{
+constexpr const char* CACHE_FILE = "bitmaps.cache";
+constexpr std::uint32_t MAGIC = 0x43'42'4d'4c; // "LMBC"
+constexpr std::uint32_t VERSION = 2;
+// The cache file is not allowed to grow beyond 512 MiB.
+constexpr std::size_t MAX_SIZE = 512 * 1024 * 1024;
+
+// Magic number, version, number of NX files and the seed of the hashes.
+constexpr std::size_t HEADER_SIZE
+    = 3 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+// Size, modification time and hash of each NX file.
+constexpr std::size_t STAMP_SIZE = 3 * sizeof(std::uint64_t);
+// Key, width, height and size of the pixel data.
+constexpr std::size_t ENTRY_SIZE = sizeof(std::uint64_t)
+                                  + 2 * sizeof(std::uint16_t)
+                                  + sizeof(std::uint32_t);
+
+template<typename T>
+T read(const unsigned char* src) noexcept
+{
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void write(std::ostream& dst, T value)
+{
+    dst.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+} // namespace
+
+BitmapCache::BitmapCache() noexcept
+    : enabled{false}, seed{0}, stamps{}, size{0}
+{
+}
+
+BitmapCache::~BitmapCache() noexcept
+{
+    save();
+}
+
+void BitmapCache::init()
+{
+    if (!Configuration::get().performance.bitmap_cache) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < NxFiles::NUM_FILES; ++i) {
+        auto stamp = HashUtility::get_filestamp(NxFiles::filenames[i]);
+        if (!stamp) {
+            return;
+        }
+
+        stamps[i] = {*stamp, 0};
+    }
+
+    file = MappedFile{CACHE_FILE};
+
+    std::size_t offset = read_header();
+    if (offset == 0) {
+        file.close();
+
+        // The NX files are already being hashed with the configured seed to
+        // answer the server's file check, so the new header uses the same
+        // hashes. Those that are not ready yet are filled in by `save()`.
+        seed = Configuration::get().network.hash_seed;
+        for (std::size_t i = 0; i < NxFiles::NUM_FILES; ++i) {
+            stamps[i].hash
+                = HashUtility::try_get_filehash(NxFiles::filenames[i], seed)
+                      .value_or(0);
+        }
+
+        writer.open(CACHE_FILE,
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+        write_header();
+        offset = HEADER_SIZE + STAMP_SIZE * NxFiles::NUM_FILES;
+    } else {
+        const unsigned char* data = file.data();
+        while (offset + ENTRY_SIZE <= file.size()) {
+            auto key = read<std::uint64_t>(data + offset);
+            auto length = read<std::uint32_t>(data + offset + ENTRY_SIZE
+                                              - sizeof(std::uint32_t));
+            if (offset + ENTRY_SIZE + length > file.size()) {
+                // The client was closed while writing this entry.
+                break;
+            }
+
+            entries.emplace(key, data + offset);
+            offset += ENTRY_SIZE + length;
+        }
+
+        // Windows only forbids truncating a mapped file, so the new entries
+        // are written while the file stays mapped. They overwrite an entry
+        // which was cut off.
+        writer.open(CACHE_FILE,
+                    std::ios::in | std::ios::out | std::ios::binary);
+        write_header();
+        writer.seekp(offset);
+    }
+
+    if (!writer) {
+        Console::get().print(
+            "[Warning] Could not write the bitmap cache file.");
+        writer.close();
+    }
+
+    size = offset;
+    enabled = true;
+}
+
+std::size_t BitmapCache::read_header()
+{
+    const unsigned char* data = file.data();
+    std::size_t offset = HEADER_SIZE + STAMP_SIZE * NxFiles::NUM_FILES;
+    if (file.size() < offset || read<std::uint32_t>(data) != MAGIC
+        || read<std::uint32_t>(data + 4) != VERSION
+        || read<std::uint32_t>(data + 8) != NxFiles::NUM_FILES) {
+        return 0;
+    }
+
+    seed = read<std::uint64_t>(data + 12);
+    for (std::size_t i = 0; i < NxFiles::NUM_FILES; ++i) {
+        const unsigned char* src = data + HEADER_SIZE + STAMP_SIZE * i;
+        Stamp cached = {
+            {read<std::uint64_t>(src), read<std::int64_t>(src + 8)},
+            read<std::uint64_t>(src + 16)};
+
+        if (cached.file != stamps[i].file) {
+            // The file was touched, so its contents have to be compared.
+            if (cached.hash == 0
+                || HashUtility::get_filehash(NxFiles::filenames[i], seed)
+                       != cached.hash) {
+                return 0;
+            }
+        }
+
+        stamps[i].hash = cached.hash;
+    }
+
+    return offset;
+}
+
+void BitmapCache::write_header()
+{
+    writer.seekp(0);
+    write(writer, MAGIC);
+    write(writer, VERSION);
+    write(writer, static_cast<std::uint32_t>(NxFiles::NUM_FILES));
+    write(writer, seed);
+    for (const Stamp& stamp : stamps) {
+        write(writer, stamp.file.size);
+        write(writer, stamp.file.mtime);
+        write(writer, stamp.hash);
+    }
+}
+
+const void* BitmapCache::get_data(const nl::bitmap& bmp)
+{
+    if (!enabled || !bmp.id()) {
+        return bmp.data();
+    }
+
+    std::uint64_t key = get_key(bmp);
+    std::uint16_t width = bmp.width();
+    std::uint16_t height = bmp.height();
+
+    if (auto iter = entries.find(key); iter != entries.end()) {
+        const unsigned char* entry = iter->second;
+        if (entry && read<std::uint16_t>(entry + 8) == width
+            && read<std::uint16_t>(entry + 10) == height) {
+            return entry + ENTRY_SIZE;
+        }
+
+        return bmp.data();
+    }
+
+    const void* data = bmp.data();
+    if (!data) {
+        return nullptr;
+    }
+
+    auto length = static_cast<std::uint32_t>(4u * width * height);
+    if (writer.is_open() && size + ENTRY_SIZE + length <= MAX_SIZE) {
+        write(writer, key);
+        write(writer, width);
+        write(writer, height);
+        write(writer, length);
+        writer.write(static_cast<const char*>(data), length);
+
+        if (!writer) {
+            Console::get().print(
+                "[Warning] Could not write the bitmap cache file.");
+            writer.close();
+        }
+
+        size += ENTRY_SIZE + length;
+        entries.emplace(key, nullptr);
+    }
+
+    return data;
+}
+
+void BitmapCache::save() noexcept
+{
+    if (!writer.is_open()) {
+        return;
+    }
+
+    // Rather than waiting for the NX files to be hashed while exiting, the
+    // hashes which are still missing are left out. The cache is then thrown
+    // away if those files are touched.
+    bool restamp = false;
+    for (std::size_t i = 0; i < NxFiles::NUM_FILES; ++i) {
+        if (stamps[i].hash == 0) {
+            auto hash
+                = HashUtility::try_get_filehash(NxFiles::filenames[i], seed);
+            if (hash) {
+                stamps[i].hash = *hash;
+                restamp = true;
+            }
+        }
+    }
+
+    if (restamp) {
+        write_header();
+    }
+
+    writer.close();
+}
+
+std::uint64_t BitmapCache::get_key(const nl::bitmap& bmp) noexcept
+{
+    // The id of a bitmap is the address of its LZ4 block inside the mapped NX
+    // file, and the block starts with its compressed length. The address
+    // changes between sessions, but the contents of the block do not.
+    const auto block = reinterpret_cast<const unsigned char*>(bmp.id());
+    auto length = read<std::uint32_t>(block);
+    std::uint64_t seed = (std::uint64_t{bmp.width()} << 16) | bmp.height();
+
+    return XXH64(block + sizeof(std::uint32_t), length, seed);
+}
+} // namespace jrc
+#endif
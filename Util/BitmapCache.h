@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Journey.h"
+
+#ifdef JOURNEY_USE_XXHASH
+#    include "../Template/Singleton.h"
+#    include "HashUtility.h"
+#    include "MappedFile.h"
+#    include "NxFiles.h"
+#    include "nlnx/bitmap.hpp"
+
+#    include <array>
+#    include <cstdint>
+#    include <fstream>
+#    include <unordered_map>
+#    include <vector>
+
+namespace jrc
+{
+//! Optional on-disk cache of decoded bitmaps.
+//!
+//! Every bitmap has to be decompressed from its NX file before it can be
+//! uploaded to the atlas. The cache stores the decoded pixels of the bitmaps
+//! used in earlier sessions in one file, which is mapped into memory on
+//! startup, so that those bitmaps skip decompression. Bitmaps decoded during
+//! a session are appended to the file as they are decoded. The whole cache
+//! is thrown away when the contents of any NX file change.
+class BitmapCache : public Singleton<BitmapCache>
+{
+public:
+    BitmapCache() noexcept;
+    //! Store the hashes of the NX files which were not known yet.
+    ~BitmapCache() noexcept override;
+
+    //! Map the cache file and check that it belongs to the current NX files.
+    //! Must be called after the NX files are loaded.
+    void init();
+
+    //! Get the decoded pixels of a bitmap, from the cache if possible. The
+    //! pointer is only valid until the next call.
+    const void* get_data(const nl::bitmap& bmp);
+
+private:
+    struct Stamp {
+        HashUtility::FileStamp file;
+        //! The hash of the file, or zero if it was not known when the header
+        //! was written.
+        std::uint64_t hash;
+    };
+
+    using Stamps = std::array<Stamp, NxFiles::NUM_FILES>;
+
+    //! Check the header of the mapped file and return the offset of the
+    //! first entry, or zero if the cache does not match the NX files.
+    std::size_t read_header();
+    void write_header();
+    void save() noexcept;
+
+    static std::uint64_t get_key(const nl::bitmap& bmp) noexcept;
+
+    bool enabled;
+    MappedFile file;
+    //! The seed of the hashes in `stamps`.
+    std::uint64_t seed;
+    Stamps stamps;
+    //! Entries of the cache file, by key. Bitmaps decoded during this session
+    //! map to `nullptr`.
+    std::unordered_map<std::uint64_t, const unsigned char*> entries;
+    //! Appends the bitmaps decoded during this session to the cache file.
+    std::fstream writer;
+    //! The size of the cache file once `writer` is flushed.
+    std::size_t size;
+};
+} // namespace jrc
+#endif
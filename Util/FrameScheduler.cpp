@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "FrameScheduler.h"
+
+#include "../Constants.h"
+#include "../Timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace jrc
+{
+FrameScheduler::FrameScheduler() noexcept
+    : frame_period{0},
+      max_steps{1},
+      fixed{false},
+      accumulator{Constants::TIMESTEP * 1'000},
+      average_frame{0},
+      input_time{0},
+      flushed_input_time{0},
+      last_latency{0},
+      worst_latency{0},
+      report_start{now()},
+      report_frames{0},
+      report_time{0},
+      report_worst{0}
+{
+}
+
+void FrameScheduler::init(std::int32_t max_fps,
+                          std::int32_t max_update_steps) noexcept
+{
+    frame_period = max_fps > 0 ? 1'000'000 / max_fps : 0;
+    max_steps = std::max(max_update_steps, 1);
+}
+
+void FrameScheduler::run_fixed() noexcept
+{
+    fixed = true;
+    accumulator = 0;
+}
+
+std::int32_t FrameScheduler::begin_frame()
+{
+    if (frame_period > 0) {
+        wait_for(frame_period);
+    }
+
+    std::int64_t elapsed = Timer::get().stop();
+    record(elapsed);
+
+    if (fixed) {
+        return 1;
+    }
+
+    std::int64_t timestep = Constants::TIMESTEP * 1'000;
+    accumulator += elapsed;
+
+    auto steps = static_cast<std::int32_t>(accumulator / timestep);
+    if (steps > max_steps) {
+        stats.dropped_steps += steps - max_steps;
+        steps = max_steps;
+    }
+
+    // Dropped steps are discarded along with the whole steps that are run;
+    // only the fraction of a step is carried over.
+    accumulator = steps == max_steps ? accumulator % timestep
+                                     : accumulator - steps * timestep;
+
+    return steps;
+}
+
+float FrameScheduler::get_alpha() const noexcept
+{
+    return static_cast<float>(accumulator)
+           / static_cast<float>(Constants::TIMESTEP * 1'000);
+}
+
+void FrameScheduler::on_input() noexcept
+{
+    if (input_time == 0) {
+        input_time = now();
+    }
+}
+
+void FrameScheduler::on_flush() noexcept
+{
+    if (input_time != 0) {
+        flushed_input_time.store(input_time, std::memory_order_relaxed);
+        input_time = 0;
+    }
+}
+
+void FrameScheduler::on_present() noexcept
+{
+    std::int64_t input
+        = flushed_input_time.exchange(0, std::memory_order_relaxed);
+    if (input == 0) {
+        return;
+    }
+
+    std::int64_t latency = now() - input;
+    last_latency.store(latency, std::memory_order_relaxed);
+
+    std::int64_t worst = worst_latency.load(std::memory_order_relaxed);
+    while (latency > worst
+           && !worst_latency.compare_exchange_weak(
+                  worst, latency, std::memory_order_relaxed)) {
+    }
+}
+
+const FrameScheduler::Stats& FrameScheduler::get_stats() const noexcept
+{
+    return stats;
+}
+
+void FrameScheduler::wait_for(std::int64_t period) const
+{
+    std::int64_t remaining = period - Timer::get().peek();
+    if (remaining > SPIN_MARGIN) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds{remaining - SPIN_MARGIN});
+    }
+
+    while (Timer::get().peek() < period) {
+        std::this_thread::yield();
+    }
+}
+
+void FrameScheduler::record(std::int64_t frame_time)
+{
+    // A frame is late if it took half again as long as it should have.
+    std::int64_t expected = frame_period > 0 ? frame_period : average_frame;
+    if (expected > 0 && frame_time * 2 > expected * 3) {
+        ++stats.late_frames;
+    }
+
+    average_frame = average_frame == 0
+                        ? frame_time
+                        : (average_frame * 15 + frame_time) / 16;
+
+    ++report_frames;
+    report_time += frame_time;
+    report_worst = std::max(report_worst, frame_time);
+
+    std::int64_t time = now();
+    std::int64_t interval = time - report_start;
+    if (interval < REPORT_INTERVAL) {
+        return;
+    }
+
+    stats.fps = static_cast<float>(report_frames) * 1'000'000.0f
+                / static_cast<float>(interval);
+    stats.frame_ms = static_cast<float>(report_time)
+                     / static_cast<float>(report_frames) / 1'000.0f;
+    stats.worst_frame_ms = static_cast<float>(report_worst) / 1'000.0f;
+    std::int64_t latency = last_latency.load(std::memory_order_relaxed);
+    std::int64_t worst = worst_latency.exchange(0, std::memory_order_relaxed);
+    stats.latency_ms = static_cast<float>(latency) / 1'000.0f;
+    stats.worst_latency_ms = static_cast<float>(worst) / 1'000.0f;
+
+    report_start = time;
+    report_frames = 0;
+    report_time = 0;
+    report_worst = 0;
+}
+
+std::int64_t FrameScheduler::now() noexcept
+{
+    using namespace std::chrono;
+
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace jrc
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Singleton.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace jrc
+{
+//! Paces the game loop.
+//!
+//! Each frame waits for the frame-rate cap, if there is one, and then runs as
+//! many fixed timesteps as have accumulated, up to a maximum. Steps beyond
+//! that maximum are dropped rather than run back to back, so that one slow
+//! frame cannot make the following ones slower still.
+//!
+//! It also measures the time from a key press to the swap of the first frame
+//! recorded after it.
+class FrameScheduler : public Singleton<FrameScheduler>
+{
+public:
+    //! Totals since startup, and measurements of the last report interval.
+    struct Stats {
+        float fps = 0.0f;
+        float frame_ms = 0.0f;
+        float worst_frame_ms = 0.0f;
+        float latency_ms = 0.0f;
+        float worst_latency_ms = 0.0f;
+        std::uint32_t late_frames = 0;
+        std::uint32_t dropped_steps = 0;
+    };
+
+    FrameScheduler() noexcept;
+
+    //! Cap the frame rate at `max_fps`, or not at all if it is 0, and run at
+    //! most `max_steps` updates per frame.
+    void init(std::int32_t max_fps, std::int32_t max_steps) noexcept;
+    //! Run exactly one update per frame without waiting, however long
+    //! frames take, so that runs can be repeated exactly.
+    void run_fixed() noexcept;
+
+    //! Wait until the next frame is due, and return the number of updates to
+    //! run in it.
+    std::int32_t begin_frame();
+    //! How far the game is between the last update and the next one.
+    float get_alpha() const noexcept;
+
+    //! Called from the key callback.
+    void on_input() noexcept;
+    //! Called when a frame has been recorded and handed over for drawing.
+    void on_flush() noexcept;
+    //! Called right after a swap, from whichever thread did it.
+    void on_present() noexcept;
+
+    const Stats& get_stats() const noexcept;
+
+private:
+    void wait_for(std::int64_t period) const;
+    void record(std::int64_t frame_time);
+    static std::int64_t now() noexcept;
+
+    //! How long before the deadline to stop sleeping and start spinning, as
+    //! sleeps can overshoot by about a scheduler tick.
+    static constexpr std::int64_t SPIN_MARGIN = 2'000;
+    //! How often the stats are recomputed, in microseconds.
+    static constexpr std::int64_t REPORT_INTERVAL = 500'000;
+
+    std::int64_t frame_period;
+    std::int32_t max_steps;
+    bool fixed;
+    std::int64_t accumulator;
+    //! Exponential average of the frame time, used as the expected frame
+    //! time when the frame rate is not capped.
+    std::int64_t average_frame;
+
+    std::int64_t input_time;
+    std::atomic<std::int64_t> flushed_input_time;
+    std::atomic<std::int64_t> last_latency;
+    std::atomic<std::int64_t> worst_latency;
+
+    std::int64_t report_start;
+    std::int64_t report_frames;
+    std::int64_t report_time;
+    std::int64_t report_worst;
+    Stats stats;
+};
+} // namespace jrc
@@ -15,70 +15,286 @@
 // You should have received a copy of the GNU Affero General Public License //
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
 //////////////////////////////////////////////////////////////////////////////
-//#pragma once
 #include "HashUtility.h"
 
 #ifdef JOURNEY_USE_XXHASH
-#    include <fstream>
+#    include "MappedFile.h"
+
+#    include <algorithm>
+#    include <atomic>
+#    include <condition_variable>
+#    include <deque>
+#    include <map>
+#    include <mutex>
+#    include <sys/stat.h>
+#    include <thread>
+#    include <utility>
 #    include <xxhash.h>
 
 namespace jrc
 {
 namespace HashUtility
 {
-// 128 MB.
-const std::size_t CHUNK_SIZE = 134217728;
+namespace
+{
+// 64 MiB.
+const std::size_t CHUNK_SIZE = 67108864;
+
+using Key = std::pair<std::string, std::uint64_t>;
 
-std::string get_filehash(const char* filename, std::uint64_t seed)
+struct Memo {
+    enum State { NONE, QUEUED, RUNNING, DONE };
+
+    State state = NONE;
+    std::optional<FileStamp> stamp;
+    std::uint64_t hash = 0;
+};
+
+// Hashes files in the background. The thread is owned here rather than by
+// `std::async`, so that the hashes it has not finished can be cancelled and
+// the thread joined before exiting.
+class Worker
 {
-    // Open file stream.
-    std::ifstream file(filename);
-
-    std::uint64_t result;
-    if (file.good()) {
-        // Get size of file.
-        file.seekg(0, std::ios_base::end);
-        std::size_t end = file.tellg();
-        file.seekg(0, std::ios_base::beg);
-
-        if (end < CHUNK_SIZE) {
-            // File size is smaller than chunk size so process all at once.
-            char* buffer = new char[end];
-            file.read(buffer, end);
-            result = XXH64(buffer, end, seed);
-            delete[] buffer;
-        } else {
-            // Read file in chunks instead.
-            char* buffer = new char[CHUNK_SIZE];
-            XXH64_state_t xxhstate;
-            XXH_errorcode error;
-
-            error = XXH64_reset(&xxhstate, seed);
-            std::size_t offset = 0;
-            while (offset < end && error == XXH_OK) {
-                file.read(buffer, CHUNK_SIZE);
-                error = XXH64_update(&xxhstate, buffer, CHUNK_SIZE);
-                offset += CHUNK_SIZE;
-            }
-            std::size_t remaining = offset - end;
-            if (remaining > 0) {
-                file.read(buffer, CHUNK_SIZE);
-                error = XXH64_update(&xxhstate, buffer, remaining);
-            }
+public:
+    ~Worker()
+    {
+        stop();
+    }
+
+    std::mutex mutex;
+    // Notified whenever a memo leaves the `QUEUED` or `RUNNING` state.
+    std::condition_variable finished;
+    std::map<Key, Memo> memos;
+    // Set for good by `stop()`. Checked between chunks, so that a hash is
+    // cancelled after at most one more chunk.
+    std::atomic<bool> stopping{false};
+
+    // Queue the hash of a file. Requires `mutex`.
+    void enqueue(const Key& key)
+    {
+        requests.push_back(key);
+        if (!thread.joinable()) {
+            thread = std::thread{&Worker::run, this};
+        }
 
-            if (error == XXH_OK) {
-                result = XXH64_digest(&xxhstate);
-            } else {
-                result = 0;
+        queued.notify_one();
+    }
+
+    // Take back a file which is queued but not being hashed yet. Requires
+    // `mutex`.
+    void dequeue(const Key& key)
+    {
+        requests.erase(std::remove(requests.begin(), requests.end(), key),
+                       requests.end());
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+            requests.clear();
+
+            for (auto& [key, memo] : memos) {
+                if (memo.state == Memo::QUEUED) {
+                    memo.state = Memo::NONE;
+                }
             }
-            delete[] buffer;
         }
-    } else {
-        result = 0;
+
+        queued.notify_one();
+        finished.notify_all();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+private:
+    void run();
+
+    std::thread thread;
+    std::condition_variable queued;
+    std::deque<Key> requests;
+};
+
+Worker worker;
+
+// Returns nothing if the hash was cancelled.
+std::optional<std::uint64_t> hash_file(const char* filename,
+                                       std::uint64_t seed,
+                                       const std::atomic<bool>* cancel)
+{
+    MappedFile file{filename};
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    XXH64_state_t* state = XXH64_createState();
+    if (!state) {
+        return 0;
+    }
+
+    // Stream the mapping through the hash state chunk by chunk.
+    const unsigned char* data = file.data();
+    const std::size_t end = file.size();
+
+    XXH_errorcode error = XXH64_reset(state, seed);
+    for (std::size_t offset = 0; offset < end && error == XXH_OK;
+         offset += CHUNK_SIZE) {
+        if (cancel && *cancel) {
+            XXH64_freeState(state);
+            return {};
+        }
+
+        std::size_t length = std::min(CHUNK_SIZE, end - offset);
+        error = XXH64_update(state, data + offset, length);
+    }
+
+    std::uint64_t result = error == XXH_OK ? XXH64_digest(state) : 0;
+    XXH64_freeState(state);
+
+    return result;
+}
+
+void Worker::run()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    while (true) {
+        queued.wait(lock, [this] { return stopping || !requests.empty(); });
+        if (stopping) {
+            return;
+        }
+
+        Key key = std::move(requests.front());
+        requests.pop_front();
+
+        Memo& memo = memos[key];
+        memo.state = Memo::RUNNING;
+
+        lock.unlock();
+        auto hash = hash_file(key.first.c_str(), key.second, &stopping);
+        lock.lock();
+
+        if (hash) {
+            memo.state = Memo::DONE;
+            memo.hash = *hash;
+        } else {
+            memo.state = Memo::NONE;
+        }
+
+        finished.notify_all();
+    }
+}
+} // namespace
+
+std::uint64_t get_filehash(const char* filename, std::uint64_t seed)
+{
+    Key key{filename, seed};
+    std::unique_lock<std::mutex> lock{worker.mutex};
+
+    while (true) {
+        auto stamp = get_filestamp(filename);
+        Memo& memo = worker.memos[key];
+
+        if (memo.state == Memo::DONE && memo.stamp == stamp) {
+            return memo.hash;
+        }
+
+        if (memo.state == Memo::RUNNING) {
+            // Even if the file changed since, the hash being calculated has
+            // to be stored before the file is hashed again.
+            worker.finished.wait(lock);
+            continue;
+        }
+
+        // Hash the file here rather than waiting for the worker to get to
+        // it.
+        if (memo.state == Memo::QUEUED) {
+            worker.dequeue(key);
+        }
+
+        memo.state = Memo::RUNNING;
+        memo.stamp = stamp;
+
+        lock.unlock();
+        std::uint64_t hash = *hash_file(filename, seed, nullptr);
+        lock.lock();
+
+        memo.state = Memo::DONE;
+        memo.hash = hash;
+        worker.finished.notify_all();
+
+        return hash;
+    }
+}
+
+std::string get_filehash_string(const char* filename, std::uint64_t seed)
+{
+    return std::to_string(get_filehash(filename, seed));
+}
+
+void prefetch_filehash(const char* filename, std::uint64_t seed)
+{
+    Key key{filename, seed};
+    auto stamp = get_filestamp(filename);
+    std::lock_guard<std::mutex> lock{worker.mutex};
+
+    if (worker.stopping) {
+        return;
+    }
+
+    Memo& memo = worker.memos[key];
+    if (memo.stamp == stamp && memo.state != Memo::NONE) {
+        return;
+    }
+
+    if (memo.state == Memo::RUNNING) {
+        // The file changed while it was being hashed. `get_filehash()`
+        // hashes it again once this hash is done.
+        return;
+    }
+
+    memo.stamp = stamp;
+    if (memo.state != Memo::QUEUED) {
+        memo.state = Memo::QUEUED;
+        worker.enqueue(key);
+    }
+}
+
+std::optional<std::uint64_t> try_get_filehash(const char* filename,
+                                              std::uint64_t seed)
+{
+    auto stamp = get_filestamp(filename);
+    std::lock_guard<std::mutex> lock{worker.mutex};
+
+    auto iter = worker.memos.find({filename, seed});
+    if (iter == worker.memos.end()) {
+        return {};
+    }
+
+    const Memo& memo = iter->second;
+    if (memo.state != Memo::DONE || memo.stamp != stamp) {
+        return {};
+    }
+
+    return memo.hash;
+}
+
+void shutdown()
+{
+    worker.stop();
+}
+
+std::optional<FileStamp> get_filestamp(const char* filename)
+{
+    struct stat info;
+    if (stat(filename, &info) != 0) {
+        return {};
     }
 
-    file.close();
-    return std::to_string(result);
+    return FileStamp{static_cast<std::uint64_t>(info.st_size),
+                     static_cast<std::int64_t>(info.st_mtime)};
 }
 } // namespace HashUtility
 } // namespace jrc
@@ -20,6 +20,7 @@
 
 #ifdef JOURNEY_USE_XXHASH
 #    include <cstdint>
+#    include <optional>
 #    include <string>
 
 namespace jrc
@@ -28,7 +29,43 @@ namespace jrc
 namespace HashUtility
 {
 // Calculate file hash using the fast xxhash algorithm.
-std::string get_filehash(const char* filename, std::uint64_t seed);
+//
+// Hashes are remembered for as long as the size and modification time of
+// the file stay the same. If the hash is still being calculated in the
+// background, this waits for it.
+std::uint64_t get_filehash(const char* filename, std::uint64_t seed);
+// Calculate file hash as a decimal string, as sent to the server.
+std::string get_filehash_string(const char* filename, std::uint64_t seed);
+// Start calculating the hash of a file on a background thread.
+void prefetch_filehash(const char* filename, std::uint64_t seed);
+// Get the hash of a file if it has already been calculated, without
+// waiting or starting to calculate it.
+std::optional<std::uint64_t> try_get_filehash(const char* filename,
+                                              std::uint64_t seed);
+// Cancel the hashes still being calculated in the background and join the
+// background thread. Files hashed afterwards are hashed on the calling
+// thread.
+void shutdown();
+
+// Size and modification time of a file, used to notice that a file changed
+// without hashing it again.
+struct FileStamp {
+    std::uint64_t size;
+    std::int64_t mtime;
+
+    bool operator==(const FileStamp& other) const noexcept
+    {
+        return size == other.size && mtime == other.mtime;
+    }
+
+    bool operator!=(const FileStamp& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+// Get the stamp of a file, or nothing if the file does not exist.
+std::optional<FileStamp> get_filestamp(const char* filename);
 } // namespace HashUtility
 } // namespace jrc
 #endif
@@ -0,0 +1,161 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "MappedFile.h"
+
+#include <utility>
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#else
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#endif
+
+namespace jrc
+{
+MappedFile::MappedFile() noexcept
+    : base{nullptr},
+      length{0}
+#ifdef _WIN32
+      ,
+      mapping{nullptr}
+#endif
+{
+}
+
+#ifndef _WIN32
+MappedFile::MappedFile(const char* filename) noexcept : MappedFile()
+{
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        auto size = static_cast<std::size_t>(info.st_size);
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            base = static_cast<const unsigned char*>(addr);
+            length = size;
+        }
+    }
+
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+}
+
+void MappedFile::close() noexcept
+{
+    if (base) {
+        ::munmap(const_cast<unsigned char*>(base), length);
+    }
+
+    base = nullptr;
+    length = 0;
+}
+#else
+MappedFile::MappedFile(const char* filename) noexcept : MappedFile()
+{
+    HANDLE file = CreateFileA(filename,
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping
+            = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            void* addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (addr) {
+                base = static_cast<const unsigned char*>(addr);
+                length = static_cast<std::size_t>(size.QuadPart);
+            } else {
+                CloseHandle(mapping);
+                mapping = nullptr;
+            }
+        }
+    }
+
+    CloseHandle(file);
+}
+
+void MappedFile::close() noexcept
+{
+    if (base) {
+        UnmapViewOfFile(base);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+
+    base = nullptr;
+    length = 0;
+    mapping = nullptr;
+}
+#endif
+
+MappedFile::~MappedFile() noexcept
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : MappedFile()
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+
+        std::swap(base, other.base);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        std::swap(mapping, other.mapping);
+#endif
+    }
+
+    return *this;
+}
+
+bool MappedFile::is_open() const noexcept
+{
+    return base != nullptr;
+}
+
+const unsigned char* MappedFile::data() const noexcept
+{
+    return base;
+}
+
+std::size_t MappedFile::size() const noexcept
+{
+    return length;
+}
+} // namespace jrc
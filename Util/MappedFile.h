@@ -0,0 +1,54 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+
+namespace jrc
+{
+//! A read-only memory mapping of a whole file.
+//!
+//! A file that could not be opened, or that is empty, maps to `nullptr` with
+//! a size of zero.
+class MappedFile
+{
+public:
+    MappedFile() noexcept;
+    explicit MappedFile(const char* filename) noexcept;
+    ~MappedFile() noexcept;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! Unmap the file, if any.
+    void close() noexcept;
+
+    bool is_open() const noexcept;
+    const unsigned char* data() const noexcept;
+    std::size_t size() const noexcept;
+
+private:
+    const unsigned char* base;
+    std::size_t length;
+#ifdef _WIN32
+    void* mapping;
+#endif
+};
+} // namespace jrc
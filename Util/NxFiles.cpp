@@ -17,7 +17,10 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "NxFiles.h"
 
+#include "../Configuration.h"
 #include "../Console.h"
+#include "BitmapCache.h"
+#include "HashUtility.h"
 #include "nlnx/node.hpp"
 #include "nlnx/nx.hpp"
 
@@ -56,6 +59,17 @@ Error NxFiles::init()
         return Error::WRONG_UI_FILE;
     }
 
+#ifdef JOURNEY_USE_XXHASH
+    // Hash the files in the background, so that the server's file check can
+    // be answered right away.
+    for (auto filename : filenames) {
+        HashUtility::prefetch_filehash(filename,
+                                       Configuration::get().network.hash_seed);
+    }
+
+    BitmapCache::get().init();
+#endif
+
     return Error::NONE;
 }
 } // namespace jrc
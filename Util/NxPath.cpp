@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "NxPath.h"
+
+#include "nlnx/nx.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace jrc
+{
+IdString::IdString() noexcept : length{0}
+{
+}
+
+IdString& IdString::append(std::int32_t id, std::size_t min_length) noexcept
+{
+    char digits[12];
+    std::size_t count = 0;
+
+    auto value = static_cast<std::uint32_t>(id);
+    if (id < 0) {
+        value = 0u - value;
+    }
+
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    if (id < 0 && length < CAPACITY) {
+        buffer[length++] = '-';
+    }
+    for (; min_length > count && length < CAPACITY; --min_length) {
+        buffer[length++] = '0';
+    }
+    while (count > 0 && length < CAPACITY) {
+        buffer[length++] = digits[--count];
+    }
+
+    return *this;
+}
+
+IdString& IdString::append(std::string_view str) noexcept
+{
+    std::size_t count = std::min(str.size(), CAPACITY - length);
+    std::memcpy(buffer + length, str.data(), count);
+    length += count;
+
+    return *this;
+}
+
+std::string_view IdString::view() const noexcept
+{
+    return {buffer, length};
+}
+
+IdString::operator std::string_view() const noexcept
+{
+    return view();
+}
+
+nl::node NodeCache::map(std::int32_t map_id)
+{
+    return find(MAP, map_id, [map_id] {
+        IdString dir;
+        dir.append("Map").append(map_id / 100'000'000);
+        IdString img;
+        img.append(map_id, 9).append(".img");
+
+        return nl::nx::map["Map"][dir][img];
+    });
+}
+
+nl::node NodeCache::mob(std::int32_t mob_id)
+{
+    return find(MOB, mob_id, [mob_id] {
+        IdString img;
+        img.append(mob_id, 7).append(".img");
+
+        return nl::nx::mob[img];
+    });
+}
+
+nl::node NodeCache::mob_sound(std::int32_t mob_id)
+{
+    return find(MOB_SOUND, mob_id, [mob_id] {
+        IdString id;
+        id.append(mob_id, 7);
+
+        return nl::nx::sound["Mob.img"][id];
+    });
+}
+
+nl::node NodeCache::mob_string(std::int32_t mob_id)
+{
+    return find(MOB_STRING, mob_id, [mob_id] {
+        IdString id;
+        id.append(mob_id);
+
+        return nl::nx::string["Mob.img"][id];
+    });
+}
+
+nl::node NodeCache::equip(std::string_view category, std::int32_t item_id)
+{
+    // The category follows from the id, so it does not need to be part of
+    // the key.
+    return find(EQUIP, item_id, [category, item_id] {
+        IdString img;
+        img.append(item_id, 8).append(".img");
+
+        return nl::nx::character[category][img];
+    });
+}
+
+nl::node NodeCache::link(nl::node src, const std::string& path)
+{
+    if (auto iter = links.find(path); iter != links.end()) {
+        return iter->second;
+    }
+
+    nl::node src_file = src;
+    while (src_file != src_file.root()) {
+        src_file = src_file.root();
+    }
+
+    nl::node target
+        = src_file.resolve(std::string_view{path}.substr(path.find('/') + 1));
+
+    return links.emplace(path, target).first->second;
+}
+} // namespace jrc
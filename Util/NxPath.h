@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Template/Singleton.h"
+#include "nlnx/node.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace jrc
+{
+//! A short string built on the stack, for NX paths made out of ids.
+class IdString
+{
+public:
+    static constexpr std::size_t CAPACITY = 32;
+
+    IdString() noexcept;
+
+    //! Append the id, prefixed with zeroes so that it has at least
+    //! `min_length` digits.
+    IdString& append(std::int32_t id, std::size_t min_length = 0) noexcept;
+    IdString& append(std::string_view str) noexcept;
+
+    std::string_view view() const noexcept;
+    operator std::string_view() const noexcept;
+
+private:
+    char buffer[CAPACITY];
+    std::size_t length;
+};
+
+//! Remembers the NX nodes found through numeric ids, so that looking up the
+//! same map, mob or equip again does not build its path again. Only to be
+//! used from the main thread.
+class NodeCache : public Singleton<NodeCache>
+{
+public:
+    //! Map.nx/Map/Map<n>/<map_id>.img
+    nl::node map(std::int32_t map_id);
+    //! Mob.nx/<mob_id>.img
+    nl::node mob(std::int32_t mob_id);
+    //! Sound.nx/Mob.img/<mob_id>
+    nl::node mob_sound(std::int32_t mob_id);
+    //! String.nx/Mob.img/<mob_id>
+    nl::node mob_string(std::int32_t mob_id);
+    //! Character.nx/<category>/<item_id>.img
+    nl::node equip(std::string_view category, std::int32_t item_id);
+
+    //! Resolve a `source` link of the bitmap node `src`. Links start with the
+    //! name of the file, and are relative to its root.
+    nl::node link(nl::node src, const std::string& path);
+
+private:
+    enum Kind : std::uint8_t { MAP, MOB, MOB_SOUND, MOB_STRING, EQUIP };
+
+    template<typename F>
+    nl::node find(Kind kind, std::int32_t id, F resolve)
+    {
+        std::uint64_t key = static_cast<std::uint64_t>(kind) << 32
+                            | static_cast<std::uint32_t>(id);
+        if (auto iter = nodes.find(key); iter != nodes.end()) {
+            return iter->second;
+        }
+
+        return nodes.emplace(key, resolve()).first->second;
+    }
+
+    std::unordered_map<std::uint64_t, nl::node> nodes;
+    std::unordered_map<std::string, nl::node> links;
+};
+} // namespace jrc
@@ -0,0 +1,190 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "Profiler.h"
+
+#ifdef JOURNEY_PROFILE
+#    include <algorithm>
+#    include <fstream>
+#    include <iomanip>
+#    include <map>
+
+namespace jrc
+{
+Profiler::Zone::Zone(const char* n) noexcept
+    : name{n}, start{Profiler::get().now()}
+{
+}
+
+Profiler::Zone::~Zone() noexcept
+{
+    Profiler& profiler = Profiler::get();
+    std::int64_t end = profiler.now();
+
+    profiler.local_buffer().push({name, start, end - start});
+}
+
+Profiler::Profiler() noexcept : origin{clock::now()}
+{
+}
+
+void Profiler::collect()
+{
+    std::vector<Buffer*> sources;
+    {
+        std::lock_guard<std::mutex> lock{buffers_mutex};
+        for (const auto& buffer : buffers) {
+            sources.push_back(buffer.get());
+        }
+    }
+
+    for (Buffer* buffer : sources) {
+        std::size_t tail = buffer->tail.load(std::memory_order_relaxed);
+        std::size_t head = buffer->head.load(std::memory_order_acquire);
+
+        for (; tail != head; ++tail) {
+            const Event& event = buffer->events[tail % Buffer::CAPACITY];
+
+            windows[event.name].add(event.duration);
+            trace.push_back({event, buffer->thread_id});
+        }
+
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+
+    while (trace.size() > TRACE_LENGTH) {
+        trace.pop_front();
+    }
+}
+
+Profiler::Stats Profiler::get_stats(std::string_view name) const
+{
+    auto iter = windows.find(name);
+    if (iter == windows.end() || iter->second.count == 0) {
+        return {0, 0, 0, 0, 0};
+    }
+
+    const Window& window = iter->second;
+    std::vector<std::int64_t> sorted(window.durations.begin(),
+                                     window.durations.begin() + window.count);
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&sorted](std::size_t p) {
+        return sorted[(sorted.size() - 1) * p / 100];
+    };
+
+    return {percentile(50),
+            percentile(95),
+            percentile(99),
+            sorted.back(),
+            sorted.size()};
+}
+
+void Profiler::print_stats(std::ostream& os) const
+{
+    // Sort by name for stable output.
+    std::map<std::string_view, Stats> all;
+    for (const auto& [name, _] : windows) {
+        all.emplace(name, get_stats(name));
+    }
+
+    os << "Frame profile (microseconds over the last " << Window::LENGTH
+       << " samples):\n";
+    for (const auto& [name, stats] : all) {
+        os << "  " << std::left << std::setw(32) << name << std::right
+           << " p50 " << std::setw(7) << stats.p50 << " p95 " << std::setw(7)
+           << stats.p95 << " p99 " << std::setw(7) << stats.p99 << " max "
+           << std::setw(7) << stats.max << '\n';
+    }
+
+    os << std::flush;
+}
+
+bool Profiler::write_trace(const char* filename) const
+{
+    std::ofstream file{filename};
+    if (!file) {
+        return false;
+    }
+
+    file << "{\"traceEvents\":[";
+
+    bool first = true;
+    for (const TraceEvent& trace_event : trace) {
+        if (!first) {
+            file << ',';
+        }
+        first = false;
+
+        // Zone names are string literals, so there is nothing to escape.
+        file << "\n{\"name\":\"" << trace_event.event.name
+             << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace_event.thread_id
+             << ",\"ts\":" << trace_event.event.start
+             << ",\"dur\":" << trace_event.event.duration << '}';
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return file.good();
+}
+
+std::int64_t Profiler::now() const noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               clock::now() - origin)
+        .count();
+}
+
+Profiler::Buffer& Profiler::local_buffer()
+{
+    thread_local Buffer* local = nullptr;
+
+    if (!local) {
+        std::lock_guard<std::mutex> lock{buffers_mutex};
+
+        auto thread_id = static_cast<std::uint32_t>(buffers.size() + 1);
+        buffers.push_back(std::make_unique<Buffer>(thread_id));
+        local = buffers.back().get();
+    }
+
+    return *local;
+}
+
+Profiler::Buffer::Buffer(std::uint32_t id) noexcept
+    : events{}, head{0}, tail{0}, thread_id{id}
+{
+}
+
+void Profiler::Buffer::push(const Event& event) noexcept
+{
+    std::size_t next = head.load(std::memory_order_relaxed);
+    if (next - tail.load(std::memory_order_acquire) >= CAPACITY) {
+        return;
+    }
+
+    events[next % CAPACITY] = event;
+    head.store(next + 1, std::memory_order_release);
+}
+
+void Profiler::Window::add(std::int64_t duration) noexcept
+{
+    durations[next] = duration;
+    next = (next + 1) % LENGTH;
+    count = std::min(count + 1, LENGTH);
+}
+} // namespace jrc
+#endif
@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Journey.h"
+
+#ifdef JOURNEY_PROFILE
+#    include "../Template/Singleton.h"
+
+#    include <array>
+#    include <atomic>
+#    include <chrono>
+#    include <cstdint>
+#    include <deque>
+#    include <memory>
+#    include <mutex>
+#    include <ostream>
+#    include <string_view>
+#    include <unordered_map>
+#    include <vector>
+
+#    define JOURNEY_ZONE_CONCAT_(a, b) a##b
+#    define JOURNEY_ZONE_CONCAT(a, b) JOURNEY_ZONE_CONCAT_(a, b)
+//! Time the rest of the enclosing scope as a zone called `name`, which has to
+//! be a string literal.
+#    define JOURNEY_ZONE(name)                                                \
+        ::jrc::Profiler::Zone JOURNEY_ZONE_CONCAT(journey_zone_, __LINE__)    \
+        {                                                                     \
+            name                                                              \
+        }
+
+namespace jrc
+{
+//! Collects timed zones from all threads.
+//!
+//! Each thread records its zones into a ring buffer of its own without
+//! locking. The main thread drains those buffers once per frame with
+//! `collect()`, keeping a rolling window of durations per zone for
+//! percentiles, and the most recent events for a Chrome trace.
+class Profiler : public Singleton<Profiler>
+{
+public:
+    //! Records the time between its construction and destruction.
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name) noexcept;
+        ~Zone() noexcept;
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        std::int64_t start;
+    };
+
+    //! Percentiles of the durations of a zone, in microseconds.
+    struct Stats {
+        std::int64_t p50;
+        std::int64_t p95;
+        std::int64_t p99;
+        std::int64_t max;
+        std::size_t samples;
+    };
+
+    Profiler() noexcept;
+
+    //! Move the events recorded by all threads into the statistics.
+    void collect();
+
+    //! Get the statistics of the zone over its recent samples.
+    Stats get_stats(std::string_view name) const;
+    //! Print the statistics of every zone.
+    void print_stats(std::ostream& os) const;
+    //! Write the collected events in the Chrome `trace_event` format, which
+    //! can be opened in chrome://tracing.
+    bool write_trace(const char* filename) const;
+
+    //! Microseconds since the profiler was created.
+    std::int64_t now() const noexcept;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Event {
+        const char* name;
+        std::int64_t start;
+        std::int64_t duration;
+    };
+
+    //! Ring of events written by one thread and read by `collect()`.
+    struct Buffer {
+        static constexpr std::size_t CAPACITY = 4096;
+
+        std::array<Event, CAPACITY> events;
+        //! Written by the owning thread only.
+        std::atomic<std::size_t> head;
+        //! Written by `collect()` only.
+        std::atomic<std::size_t> tail;
+        std::uint32_t thread_id;
+
+        explicit Buffer(std::uint32_t thread_id) noexcept;
+
+        //! Add an event, dropping it if the ring is full.
+        void push(const Event& event) noexcept;
+    };
+
+    struct Window {
+        static constexpr std::size_t LENGTH = 256;
+
+        std::array<std::int64_t, LENGTH> durations;
+        std::size_t count = 0;
+        std::size_t next = 0;
+
+        void add(std::int64_t duration) noexcept;
+    };
+
+    struct TraceEvent {
+        Event event;
+        std::uint32_t thread_id;
+    };
+
+    //! The buffer of the calling thread.
+    Buffer& local_buffer();
+
+    static constexpr std::size_t TRACE_LENGTH = 1 << 18;
+
+    clock::time_point origin;
+
+    std::mutex buffers_mutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    std::unordered_map<std::string_view, Window> windows;
+    std::deque<TraceEvent> trace;
+};
+} // namespace jrc
+#else
+#    define JOURNEY_ZONE(name)
+#endif
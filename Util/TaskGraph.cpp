@@ -0,0 +1,252 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#include "TaskGraph.h"
+
+#include <iomanip>
+#include <thread>
+
+namespace jrc
+{
+TaskGraph::TaskGraph() noexcept : origin{clock::now()}
+{
+}
+
+TaskGraph::Id TaskGraph::add(const char* name,
+                             Affinity affinity,
+                             std::initializer_list<Id> deps,
+                             Task task)
+{
+    stages.push_back({name,
+                      affinity,
+                      deps,
+                      std::move(task),
+                      PENDING,
+                      Error::NONE,
+                      {},
+                      {}});
+
+    return stages.size() - 1;
+}
+
+Error TaskGraph::run()
+{
+    std::vector<std::thread> workers;
+    std::size_t running = 0;
+
+    std::unique_lock<std::mutex> lock{mutex};
+    for (;;) {
+        bool started = false;
+        bool pending = false;
+
+        for (Id id = 0; id < stages.size(); ++id) {
+            Stage& stage = stages[id];
+            if (stage.state != PENDING || stage.affinity == DEFERRED) {
+                continue;
+            }
+
+            if (is_blocked(stage)) {
+                stage.state = SKIPPED;
+                started = true;
+                continue;
+            }
+
+            if (!is_ready(stage)) {
+                pending = true;
+                continue;
+            }
+
+            stage.state = RUNNING;
+            started = true;
+
+            if (stage.affinity == WORKER) {
+                ++running;
+                workers.emplace_back([this, id, &running] {
+                    execute(id);
+
+                    std::lock_guard<std::mutex> worker_lock{mutex};
+                    --running;
+                    finished.notify_all();
+                });
+            } else {
+                lock.unlock();
+                execute(id);
+                lock.lock();
+            }
+        }
+
+        if (started) {
+            continue;
+        }
+
+        if (running == 0) {
+            // Either everything is done, or the remaining stages wait on a
+            // dependency which will never finish.
+            if (pending) {
+                for (Stage& stage : stages) {
+                    if (stage.state == PENDING
+                        && stage.affinity != DEFERRED) {
+                        stage.state = SKIPPED;
+                    }
+                }
+            }
+            break;
+        }
+
+        finished.wait(lock);
+    }
+    lock.unlock();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (const Stage& stage : stages) {
+        if (stage.state == FAILED) {
+            return stage.error;
+        }
+    }
+
+    return Error::NONE;
+}
+
+bool TaskGraph::run_deferred()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    for (Id id = 0; id < stages.size(); ++id) {
+        Stage& stage = stages[id];
+        if (stage.state != PENDING || stage.affinity != DEFERRED) {
+            continue;
+        }
+
+        if (is_blocked(stage)) {
+            stage.state = SKIPPED;
+            continue;
+        }
+
+        if (!is_ready(stage)) {
+            continue;
+        }
+
+        stage.state = RUNNING;
+        lock.unlock();
+        execute(id);
+
+        return true;
+    }
+
+    return false;
+}
+
+void TaskGraph::print_timings(std::ostream& os) const
+{
+    using std::chrono::milliseconds;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    clock::time_point last_end = origin;
+    for (const Stage& stage : stages) {
+        if (stage.affinity != DEFERRED && stage.end > last_end) {
+            last_end = stage.end;
+        }
+    }
+
+    auto to_ms = [](clock::duration duration) {
+        return std::chrono::duration_cast<milliseconds>(duration).count();
+    };
+
+    os << "Startup timings (" << to_ms(last_end - origin)
+       << " ms until the login screen):\n";
+
+    for (const Stage& stage : stages) {
+        os << "    " << std::left << std::setw(16) << stage.name;
+
+        switch (stage.affinity) {
+        case MAIN:
+            os << std::setw(10) << "main";
+            break;
+        case WORKER:
+            os << std::setw(10) << "worker";
+            break;
+        case DEFERRED:
+            os << std::setw(10) << "deferred";
+            break;
+        }
+
+        switch (stage.state) {
+        case DONE:
+        case FAILED:
+            os << std::right << std::setw(6) << to_ms(stage.start - origin)
+               << " ms +" << std::setw(6) << to_ms(stage.end - stage.start)
+               << " ms";
+            if (stage.state == FAILED) {
+                os << " (failed)";
+            }
+            break;
+        case SKIPPED:
+            os << "skipped";
+            break;
+        default:
+            os << "not run";
+            break;
+        }
+
+        os << '\n';
+    }
+
+    os << std::flush;
+}
+
+bool TaskGraph::is_ready(const Stage& stage) const noexcept
+{
+    for (Id dep : stage.deps) {
+        if (stages[dep].state != DONE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TaskGraph::is_blocked(const Stage& stage) const noexcept
+{
+    for (Id dep : stage.deps) {
+        State state = stages[dep].state;
+        if (state == FAILED || state == SKIPPED) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskGraph::execute(Id id)
+{
+    Stage& stage = stages[id];
+
+    clock::time_point start = clock::now();
+    Error error = stage.task();
+    clock::time_point end = clock::now();
+
+    std::lock_guard<std::mutex> lock{mutex};
+    stage.start = start;
+    stage.end = end;
+    stage.error = error;
+    stage.state = error ? FAILED : DONE;
+    finished.notify_all();
+}
+} // namespace jrc
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the LibreMaple MMORPG client                        //
+// Copyright © 2015-2016 Daniel Allendorf, 2018-2019 LibreMaple Team        //
+//                                                                          //
+// This program is free software: you can redistribute it and/or modify     //
+// it under the terms of the GNU Affero General Public License as           //
+// published by the Free Software Foundation, either version 3 of the       //
+// License, or (at your option) any later version.                          //
+//                                                                          //
+// This program is distributed in the hope that it will be useful,          //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of           //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            //
+// GNU Affero General Public License for more details.                      //
+//                                                                          //
+// You should have received a copy of the GNU Affero General Public License //
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.   //
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "../Error.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace jrc
+{
+//! A graph of initialization stages. Each stage is started as soon as all of
+//! the stages it depends on have finished, so independent stages overlap.
+//!
+//! * `MAIN` stages run on the thread calling `run()`. Anything touching the
+//!   GL context or GLFW has to be a `MAIN` stage.
+//! * `WORKER` stages run on a thread of their own.
+//! * `DEFERRED` stages are skipped by `run()`, and are instead executed one
+//!   at a time by `run_deferred()` on the calling thread.
+class TaskGraph
+{
+public:
+    enum Affinity { MAIN, WORKER, DEFERRED };
+
+    using Id = std::size_t;
+    using Task = std::function<Error()>;
+
+    TaskGraph() noexcept;
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    //! Add a stage which may start once all of `deps` have finished. Must
+    //! not be called while the graph is running.
+    Id add(const char* name,
+           Affinity affinity,
+           std::initializer_list<Id> deps,
+           Task task);
+
+    //! Run all `MAIN` and `WORKER` stages and wait for them to finish.
+    //!
+    //! Stages which depend on a failed stage are skipped. Returns the error
+    //! of the first failed stage, in the order they were added.
+    Error run();
+    //! Run the first deferred stage whose dependencies have finished.
+    //! Returns `false` once there is nothing left to run.
+    bool run_deferred();
+
+    //! Print how long each stage took and when it started, relative to the
+    //! construction of the graph.
+    void print_timings(std::ostream& os) const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    enum State { PENDING, RUNNING, DONE, FAILED, SKIPPED };
+
+    struct Stage {
+        const char* name;
+        Affinity affinity;
+        std::vector<Id> deps;
+        Task task;
+        State state;
+        Error error;
+        clock::time_point start;
+        clock::time_point end;
+    };
+
+    //! Whether all dependencies of the stage are done. Requires `mutex`.
+    bool is_ready(const Stage& stage) const noexcept;
+    //! Whether a dependency of the stage failed or was skipped. Requires
+    //! `mutex`.
+    bool is_blocked(const Stage& stage) const noexcept;
+    //! Run the stage's task without holding `mutex`, then record the result.
+    void execute(Id id);
+
+    std::vector<Stage> stages;
+    mutable std::mutex mutex;
+    std::condition_variable finished;
+    clock::time_point origin;
+};
+} // namespace jrc